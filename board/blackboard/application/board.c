@@ -95,9 +95,13 @@ void appBoardInit(struct Board *board)
   if (board->eventTimer == NULL)
     panic(led, board->watchdog);
 
+  board->jobTimer = boardMakeJobTimer();
+  if (board->jobTimer == NULL)
+    panic(led, board->watchdog);
+
   /* CAN */
 
-  board->can = boardMakeCan();
+  board->can = boardMakeCan(board->chronoTimer);
   if (board->can == NULL)
     panic(led, board->watchdog);
 
@@ -138,6 +142,7 @@ void appBoardInit(struct Board *board)
       .can = board->can,
       .serial = board->serial,
       .chrono = board->chronoTimer,
+      .jobs = board->jobTimer,
       .error = board->error,
       .status = board->status,
       .settings = &board->configContext,
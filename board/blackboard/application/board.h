@@ -19,6 +19,7 @@ struct Board
   struct Interface *serial;
   struct Timer *chronoTimer;
   struct Timer *eventTimer;
+  struct Timer *jobTimer;
   struct Watchdog *watchdog;
 
   struct Indicator *error;
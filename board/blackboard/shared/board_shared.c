@@ -109,9 +109,11 @@ void boardSetupLowPriorityWQ(void)
   WQ_LP = init(WorkQueueIrq, &wqConfig);
 }
 /*----------------------------------------------------------------------------*/
-struct Interface *boardMakeCan(void)
+struct Interface *boardMakeCan(struct Timer *timer)
 {
-  static const struct CanConfig canConfig = {
+  /* Timer is used for timestamping of received frames */
+  const struct CanConfig canConfig = {
+      .timer = timer,
       .rate = 100000,
       .rxBuffers = 32,
       /* TX buffer count should be at least SERIALIZED_QUEUE_SIZE */
@@ -140,6 +142,17 @@ struct Timer *boardMakeEventTimer(void)
   return init(SysTick, &(struct SysTickConfig){PRI_TIMER});
 }
 /*----------------------------------------------------------------------------*/
+struct Timer *boardMakeJobTimer(void)
+{
+  static const struct GpTimerConfig jobTimerConfig = {
+      .frequency = 1000000,
+      .priority = PRI_TIMER,
+      .channel = TIM3
+  };
+
+  return init(GpTimer, &jobTimerConfig);
+}
+/*----------------------------------------------------------------------------*/
 struct Timer *boardMakeMemoryTimer(void)
 {
   static const struct GpTimerConfig eepromTimerConfig = {
@@ -31,9 +31,10 @@ bool boardSetupClock(void);
 void boardSetupDefaultWQ(void);
 void boardSetupLowPriorityWQ(void);
 
-struct Interface *boardMakeCan(void);
+struct Interface *boardMakeCan(struct Timer *);
 struct Timer *boardMakeChronoTimer(void);
 struct Timer *boardMakeEventTimer(void);
+struct Timer *boardMakeJobTimer(void);
 struct Timer *boardMakeMemoryTimer(void);
 struct Interface *boardMakeI2C(void);
 struct Interface *boardMakeSerial(struct Usb *);
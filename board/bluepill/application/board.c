@@ -28,24 +28,18 @@
 #define EVENT_RATE 50
 #define MAX_BLINKS 16
 /*----------------------------------------------------------------------------*/
-static const struct CanConfig canConfig = {
-    .timer = 0,
-    .rate = 1000000,
-    .rxBuffers = 16,
-    /* TX buffer count should be at least SERIALIZED_QUEUE_SIZE */
-    .txBuffers = 16,
-    .rx = PIN(PORT_B, 8),
-    .tx = PIN(PORT_B, 9),
-    .priority = PRI_CAN,
-    .channel = 0
-};
-
 static const struct GpTimerConfig baseTimerConfig = {
     .frequency = 1000000,
     .priority = PRI_CHRONO,
     .channel = TIM2
 };
 
+static const struct GpTimerConfig jobTimerConfig = {
+    .frequency = 1000000,
+    .priority = PRI_TIMER,
+    .channel = TIM3
+};
+
 static const struct SysTickConfig eventTimerConfig = {
     .priority = PRI_TIMER
 };
@@ -146,12 +140,26 @@ void boardSetup(struct Board *board)
   board->eventTimer = init(SysTick, &eventTimerConfig);
   assert(board->eventTimer != NULL);
 
+  board->jobTimer = init(GpTimer, &jobTimerConfig);
+  assert(board->jobTimer != NULL);
+
   board->chronoTimer = init(LifetimeTimer32,
       &(struct LifetimeTimer32Config){board->baseTimer});
   assert(board->chronoTimer != NULL);
 
-  /* CAN */
-
+  /* CAN, chrono timer is used for timestamping of received frames */
+
+  const struct CanConfig canConfig = {
+      .timer = board->chronoTimer,
+      .rate = 1000000,
+      .rxBuffers = 16,
+      /* TX buffer count should be at least SERIALIZED_QUEUE_SIZE */
+      .txBuffers = 16,
+      .rx = PIN(PORT_B, 8),
+      .tx = PIN(PORT_B, 9),
+      .priority = PRI_CAN,
+      .channel = 0
+  };
   board->can = init(Can, &canConfig);
   assert(board->can != NULL);
 
@@ -169,6 +177,7 @@ void boardSetup(struct Board *board)
       .can = board->can,
       .serial = board->serial,
       .chrono = board->chronoTimer,
+      .jobs = board->jobTimer,
       .error = board->error,
       .status = board->status,
       .settings = NULL,
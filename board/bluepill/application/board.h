@@ -20,6 +20,7 @@ struct Board
   struct Timer *baseTimer;
   struct Timer *chronoTimer;
   struct Timer *eventTimer;
+  struct Timer *jobTimer;
   struct Watchdog *watchdog;
 
   struct Indicator *error;
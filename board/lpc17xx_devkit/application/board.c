@@ -28,10 +28,16 @@ static const struct LedIndicatorConfig errorLedConfig = {
     .inversion = false
 };
 
-static const struct LedIndicatorConfig portLedConfig = {
-    .pin = BOARD_LED_BUSY,
-    .limit = MAX_BLINKS,
-    .inversion = true
+static const struct LedIndicatorConfig portLedConfigs[BOARD_CAN_COUNT] = {
+    {
+        .pin = BOARD_LED_BUSY_1,
+        .limit = MAX_BLINKS,
+        .inversion = true
+    }, {
+        .pin = BOARD_LED_BUSY_2,
+        .limit = MAX_BLINKS,
+        .inversion = true
+    }
 };
 /*----------------------------------------------------------------------------*/
 static void onConfigLoaded(void *argument, bool)
@@ -41,10 +47,13 @@ static void onConfigLoaded(void *argument, bool)
   makeSerialNumber(board->number, board->config.serial);
   boardMakeUsbStrings(board->usb, board->number);
 
-  if (board->config.initial[0] != -1)
+  for (size_t i = 0; i < board->hub->size; ++i)
   {
-    proxyPortChangeMode(&board->hub->ports[0], SLCAN_MODE_ACTIVE,
-        slcanRatePresetToValue((unsigned int)board->config.initial[0]));
+    if (board->config.initial[i] != -1)
+    {
+      proxyPortChangeMode(&board->hub->ports[i], SLCAN_MODE_ACTIVE,
+          slcanRatePresetToValue((unsigned int)board->config.initial[i]));
+    }
   }
 
   usbDevSetConnected(board->usb, true);
@@ -95,20 +104,35 @@ void appBoardInit(struct Board *board)
   if (board->eventTimer == NULL)
     panic(led, board->watchdog);
 
+  for (size_t i = 0; i < BOARD_CAN_COUNT; ++i)
+  {
+    board->jobTimer[i] = boardMakeJobTimer(i);
+    if (board->jobTimer[i] == NULL)
+      panic(led, board->watchdog);
+  }
+
   /* CAN */
 
-  board->can = boardMakeCan();
-  if (board->can == NULL)
-    panic(led, board->watchdog);
+  for (size_t i = 0; i < BOARD_CAN_COUNT; ++i)
+  {
+    board->can[i] = boardMakeCan(board->chronoTimer, i);
+    if (board->can[i] == NULL)
+      panic(led, board->watchdog);
+  }
 
   /* USB */
 
   board->usb = boardMakeUsb();
   if (board->usb == NULL)
     panic(led, board->watchdog);
-  board->serial = boardMakeSerial(board->usb);
-  if (board->serial == NULL)
-    panic(led, board->watchdog);
+
+  /* Each CAN port is a separate CDC function of the composite device */
+  for (size_t i = 0; i < BOARD_CAN_COUNT; ++i)
+  {
+    board->serial[i] = boardMakeSerial(board->usb, i);
+    if (board->serial[i] == NULL)
+      panic(led, board->watchdog);
+  }
 
   /* I2C and parameter storage, start Low-Priority Work Queue */
 
@@ -124,27 +148,37 @@ void appBoardInit(struct Board *board)
   board->error = init(LedIndicator, &errorLedConfig);
   if (board->error == NULL)
     panic(led, board->watchdog);
-  board->status = init(LedIndicator, &portLedConfig);
-  if (board->status == NULL)
-    panic(led, board->watchdog);
+
+  for (size_t i = 0; i < BOARD_CAN_COUNT; ++i)
+  {
+    board->status[i] = init(LedIndicator, &portLedConfigs[i]);
+    if (board->status[i] == NULL)
+      panic(led, board->watchdog);
+  }
 
   /* Create port hub and initialize all ports */
 
-  board->hub = makeProxyHub(1);
+  board->hub = makeProxyHub(BOARD_CAN_COUNT);
   if (board->hub == NULL)
     panic(led, board->watchdog);
 
-  const struct ProxyPortConfig proxyPortConfig = {
-      .can = board->can,
-      .serial = board->serial,
-      .chrono = board->chronoTimer,
-      .error = board->error,
-      .status = board->status,
-      .settings = &board->configContext,
-      .number = SLCAN_PORT_1
-  };
-  if (!proxyPortInit(&board->hub->ports[0], &proxyPortConfig))
-    panic(led, board->watchdog);
+  for (size_t i = 0; i < BOARD_CAN_COUNT; ++i)
+  {
+    const struct ProxyPortConfig proxyPortConfig = {
+        .can = board->can[i],
+        .serial = board->serial[i],
+        .chrono = board->chronoTimer,
+        .jobs = board->jobTimer[i],
+        .filters = boardGetCanFilters(i),
+        .error = board->error,
+        .status = board->status[i],
+        .settings = &board->configContext,
+        .number = (enum CanProxyNumber)(SLCAN_PORT_1 + i)
+    };
+
+    if (!proxyPortInit(&board->hub->ports[i], &proxyPortConfig))
+      panic(led, board->watchdog);
+  }
 }
 /*----------------------------------------------------------------------------*/
 int appBoardStart(struct Board *board)
@@ -6,6 +6,7 @@
 
 #include "board_shared.h"
 #include "version.h"
+#include <assert.h>
 #include <dpm/memory/m24.h>
 #include <halm/core/cortex/systick.h>
 #include <halm/generic/work_queue.h>
@@ -103,17 +104,26 @@ void boardSetupLowPriorityWQ(void)
   WQ_LP = init(WorkQueueIrq, &wqConfig);
 }
 /*----------------------------------------------------------------------------*/
-struct Interface *boardMakeCan(void)
+struct Interface *boardMakeCan(struct Timer *timer, size_t index)
 {
-  static const struct CanConfig canConfig = {
+  static const PinNumber canPins[BOARD_CAN_COUNT][2] = {
+      {PIN(0, 0), PIN(0, 1)},
+      {PIN(0, 4), PIN(0, 5)}
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+
+  /* Timer is used for timestamping of received frames */
+  const struct CanConfig canConfig = {
+      .timer = timer,
       .rate = 10000,
       .rxBuffers = 32,
       /* TX buffer count should be at least SERIALIZED_QUEUE_SIZE */
       .txBuffers = 32,
-      .rx = PIN(0, 0),
-      .tx = PIN(0, 1),
+      .rx = canPins[index][0],
+      .tx = canPins[index][1],
       .priority = PRI_CAN,
-      .channel = 0
+      .channel = (uint8_t)index
   };
 
   return init(Can, &canConfig);
@@ -135,6 +145,25 @@ struct Timer *boardMakeEventTimer(void)
   return init(SysTick, &(struct SysTickConfig){PRI_TIMER});
 }
 /*----------------------------------------------------------------------------*/
+struct Timer *boardMakeJobTimer(size_t index)
+{
+  /* Each port needs its own timer for cyclic jobs */
+  static const struct GpTimerConfig jobTimerConfigs[BOARD_CAN_COUNT] = {
+      {
+          .frequency = 1000000,
+          .priority = PRI_TIMER,
+          .channel = 2
+      }, {
+          .frequency = 1000000,
+          .priority = PRI_TIMER,
+          .channel = 3
+      }
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+  return init(GpTimer, &jobTimerConfigs[index]);
+}
+/*----------------------------------------------------------------------------*/
 struct Timer *boardMakeMemoryTimer(void)
 {
   static const struct GpTimerConfig eepromTimerConfig = {
@@ -159,8 +188,16 @@ struct Interface *boardMakeI2C(void)
   return init(I2C, &i2cConfig);
 }
 /*----------------------------------------------------------------------------*/
-struct Interface *boardMakeSerial(struct Usb *usb)
+struct Interface *boardMakeSerial(struct Usb *usb, size_t index)
 {
+  /* Interrupt, bulk OUT and bulk IN endpoints of each CDC function */
+  static const uint8_t cdcEndpoints[BOARD_CAN_COUNT][3] = {
+      {0x81, 0x02, 0x82},
+      {0x84, 0x05, 0x85}
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+
   /* CDC */
   const struct CdcAcmConfig config = {
       .device = usb,
@@ -168,9 +205,9 @@ struct Interface *boardMakeSerial(struct Usb *usb)
       .txBuffers = 8,
 
       .endpoints = {
-          .interrupt = 0x81,
-          .rx = 0x02,
-          .tx = 0x82
+          .interrupt = cdcEndpoints[index][0],
+          .rx = cdcEndpoints[index][1],
+          .tx = cdcEndpoints[index][2]
       }
   };
 
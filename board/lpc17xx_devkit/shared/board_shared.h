@@ -14,9 +14,14 @@
 #define BOARD_LED_G_PIN PIN(1, 9)
 #define BOARD_LED_B_PIN PIN(1, 8)
 
-#define BOARD_LED_BUSY  BOARD_LED_G_PIN
-#define BOARD_LED_ERROR BOARD_LED_R_PIN
+/* Status LEDs of the first and the second CAN ports */
+#define BOARD_LED_BUSY_1  BOARD_LED_G_PIN
+#define BOARD_LED_BUSY_2  BOARD_LED_B_PIN
+#define BOARD_LED_ERROR   BOARD_LED_R_PIN
+
+#define BOARD_CAN_COUNT   2
 /*----------------------------------------------------------------------------*/
+struct FilterBankLayout;
 struct Interface;
 struct Timer;
 struct Usb;
@@ -35,12 +40,14 @@ bool boardSetupClock(void);
 void boardSetupDefaultWQ(void);
 void boardSetupLowPriorityWQ(void);
 
-struct Interface *boardMakeCan(void);
+const struct FilterBankLayout *boardGetCanFilters(size_t);
+struct Interface *boardMakeCan(struct Timer *, size_t);
 struct Timer *boardMakeChronoTimer(void);
 struct Timer *boardMakeEventTimer(void);
+struct Timer *boardMakeJobTimer(size_t);
 struct Timer *boardMakeMemoryTimer(void);
 struct Interface *boardMakeI2C(void);
-struct Interface *boardMakeSerial(struct Usb *);
+struct Interface *boardMakeSerial(struct Usb *, size_t);
 struct Usb *boardMakeUsb(void);
 void boardMakeUsbStrings(struct Usb *, const char *);
 struct Watchdog *boardMakeWatchdog(void);
@@ -0,0 +1,278 @@
+/*
+ * board/lpc17xx_devkit/shared/can_filters.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "board_shared.h"
+#include "filter_bank.h"
+#include <assert.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * The Can driver has no interface to the acceptance filter tables, they are
+ * written directly. The driver switches AFMR to the bypass mode when
+ * a controller is initialized or its mode is changed, the proxy programs
+ * its bank again after each mode change. At other times the tables and
+ * AFMR are owned by this file.
+ */
+
+/* Acceptance filter RAM and registers, see the LPC17xx user manual */
+#define AF_RAM_BASE     0x40038000UL
+#define AF_RAM_WORDS    512
+#define AF_REG_BASE     0x4003C000UL
+
+#define AFMR_ACC_BP     (1UL << 1)
+
+/* Standard entry: controller number, disable bit and identifier */
+#define STD_ENTRY(channel, id)  (((uint32_t)(channel) << 13) | (id))
+#define STD_DISABLED            STD_ENTRY(7, (1UL << 12) | 0x7FF)
+/* Extended entry: controller number and identifier */
+#define EXT_ENTRY(channel, id)  (((uint32_t)(channel) << 29) | (id))
+
+/* Each slot occupies two words of the shared acceptance filter RAM */
+#define FILTER_SLOTS    128
+/*----------------------------------------------------------------------------*/
+struct AcceptanceFilter
+{
+  volatile uint32_t AFMR;
+  volatile uint32_t SFF_SA;
+  volatile uint32_t SFF_GRP_SA;
+  volatile uint32_t EFF_SA;
+  volatile uint32_t EFF_GRP_SA;
+  volatile uint32_t ENDOFTABLE;
+};
+/*----------------------------------------------------------------------------*/
+static size_t countTableWords(void);
+static bool programChannel(size_t, const struct FilterBank *);
+static bool programFirstChannel(struct Interface *, const struct FilterBank *);
+static bool programSecondChannel(struct Interface *,
+    const struct FilterBank *);
+static size_t writeGroups(volatile uint32_t *, size_t, enum FilterEntryKind);
+static size_t writeLists(volatile uint32_t *, size_t, enum FilterEntryKind);
+static void writeTables(void);
+/*----------------------------------------------------------------------------*/
+static_assert(FILTER_SLOTS * 2 * BOARD_CAN_COUNT <= AF_RAM_WORDS,
+    "Filter slots do not fit in the acceptance filter RAM");
+
+static const struct FilterBankLayout layouts[BOARD_CAN_COUNT] = {
+    {
+        .program = programFirstChannel,
+        .slots = FILTER_SLOTS,
+        .entries = {4, 2, 2, 1},
+        .ranges = true
+    }, {
+        .program = programSecondChannel,
+        .slots = FILTER_SLOTS,
+        .entries = {4, 2, 2, 1},
+        .ranges = true
+    }
+};
+
+/* Banks are owned by proxies and remain valid until the next programming */
+static const struct FilterBank *banks[BOARD_CAN_COUNT];
+/*----------------------------------------------------------------------------*/
+static size_t countTableWords(void)
+{
+  size_t lists = 0;
+  size_t words = 0;
+
+  for (size_t channel = 0; channel < BOARD_CAN_COUNT; ++channel)
+  {
+    const struct FilterBank * const bank = banks[channel];
+
+    if (bank == NULL)
+    {
+      /* Standard range takes one word and extended range takes two words */
+      words += 3;
+      continue;
+    }
+
+    for (size_t i = 0; i < bank->count; ++i)
+    {
+      switch (bank->entries[i].kind)
+      {
+        case FILTER_STD_ID:
+          ++lists;
+          break;
+
+        case FILTER_EXT_MASK:
+          words += 2;
+          break;
+
+        default:
+          ++words;
+          break;
+      }
+    }
+  }
+
+  /* Two standard list entries share a word */
+  return words + (lists + 1) / 2;
+}
+/*----------------------------------------------------------------------------*/
+static bool programChannel(size_t channel, const struct FilterBank *bank)
+{
+  banks[channel] = bank;
+
+  /* Size of the tables is checked before the filter RAM is changed */
+  if (countTableWords() > AF_RAM_WORDS)
+  {
+    /* Channel accepts all frames, the proxy filters them in software */
+    banks[channel] = NULL;
+    writeTables();
+    return false;
+  }
+
+  writeTables();
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool programFirstChannel(struct Interface *,
+    const struct FilterBank *bank)
+{
+  return programChannel(0, bank);
+}
+/*----------------------------------------------------------------------------*/
+static bool programSecondChannel(struct Interface *,
+    const struct FilterBank *bank)
+{
+  return programChannel(1, bank);
+}
+/*----------------------------------------------------------------------------*/
+static size_t writeGroups(volatile uint32_t *ram, size_t position,
+    enum FilterEntryKind kind)
+{
+  const bool extended = kind == FILTER_EXT_MASK;
+  const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+
+  for (size_t channel = 0; channel < BOARD_CAN_COUNT; ++channel)
+  {
+    const struct FilterBank * const bank = banks[channel];
+
+    if (bank == NULL)
+    {
+      /* Channel without hardware filtering accepts the whole range */
+      if (extended)
+      {
+        ram[position++] = EXT_ENTRY(channel, 0);
+        ram[position++] = EXT_ENTRY(channel, limit);
+      }
+      else
+      {
+        ram[position++] = STD_ENTRY(channel, 0) << 16
+            | STD_ENTRY(channel, limit);
+      }
+
+      continue;
+    }
+
+    for (size_t i = 0; i < bank->count; ++i)
+    {
+      const struct FilterBankEntry * const entry = bank->entries + i;
+
+      if (entry->kind != kind)
+        continue;
+
+      /* Mask entries are converted to ranges from the lowest identifier */
+      const uint32_t low = entry->id & ~entry->mask & limit;
+      const uint32_t high = (entry->id | entry->mask) & limit;
+
+      if (extended)
+      {
+        ram[position++] = EXT_ENTRY(channel, low);
+        ram[position++] = EXT_ENTRY(channel, high);
+      }
+      else
+      {
+        ram[position++] = STD_ENTRY(channel, low) << 16
+            | STD_ENTRY(channel, high);
+      }
+    }
+  }
+
+  return position;
+}
+/*----------------------------------------------------------------------------*/
+static size_t writeLists(volatile uint32_t *ram, size_t position,
+    enum FilterEntryKind kind)
+{
+  const bool extended = kind == FILTER_EXT_ID;
+  uint32_t pending = 0;
+  bool half = false;
+
+  for (size_t channel = 0; channel < BOARD_CAN_COUNT; ++channel)
+  {
+    const struct FilterBank * const bank = banks[channel];
+
+    if (bank == NULL)
+      continue;
+
+    for (size_t i = 0; i < bank->count; ++i)
+    {
+      const struct FilterBankEntry * const entry = bank->entries + i;
+
+      if (entry->kind != kind)
+        continue;
+
+      if (extended)
+      {
+        ram[position++] = EXT_ENTRY(channel, entry->id);
+      }
+      else if (half)
+      {
+        /* Two standard entries share a word, the lower entry goes first */
+        ram[position++] = pending | STD_ENTRY(channel, entry->id);
+        half = false;
+      }
+      else
+      {
+        pending = STD_ENTRY(channel, entry->id) << 16;
+        half = true;
+      }
+    }
+  }
+
+  /* Odd number of standard entries is completed with a disabled entry */
+  if (half)
+    ram[position++] = pending | STD_DISABLED;
+
+  return position;
+}
+/*----------------------------------------------------------------------------*/
+static void writeTables(void)
+{
+  struct AcceptanceFilter * const reg = (struct AcceptanceFilter *)AF_REG_BASE;
+  volatile uint32_t * const ram = (volatile uint32_t *)AF_RAM_BASE;
+  bool enabled = false;
+
+  for (size_t channel = 0; channel < BOARD_CAN_COUNT; ++channel)
+    enabled = enabled || banks[channel] != NULL;
+
+  /* Tables may be changed only while the filter is bypassed */
+  reg->AFMR = AFMR_ACC_BP;
+
+  if (!enabled)
+    return;
+
+  size_t position = 0;
+
+  /* Sections should follow each other in this order */
+  reg->SFF_SA = position * sizeof(uint32_t);
+  position = writeLists(ram, position, FILTER_STD_ID);
+  reg->SFF_GRP_SA = position * sizeof(uint32_t);
+  position = writeGroups(ram, position, FILTER_STD_MASK);
+  reg->EFF_SA = position * sizeof(uint32_t);
+  position = writeLists(ram, position, FILTER_EXT_ID);
+  reg->EFF_GRP_SA = position * sizeof(uint32_t);
+  position = writeGroups(ram, position, FILTER_EXT_MASK);
+  reg->ENDOFTABLE = position * sizeof(uint32_t);
+
+  reg->AFMR = 0;
+}
+/*----------------------------------------------------------------------------*/
+const struct FilterBankLayout *boardGetCanFilters(size_t index)
+{
+  assert(index < BOARD_CAN_COUNT);
+  return &layouts[index];
+}
@@ -15,14 +15,15 @@ struct ProxyHub;
 struct Board
 {
   struct Usb *usb;
-  struct Interface *can;
-  struct Interface *serial;
+  struct Interface *can[BOARD_CAN_COUNT];
+  struct Interface *serial[BOARD_CAN_COUNT];
   struct Timer *chronoTimer;
   struct Timer *eventTimer;
+  struct Timer *jobTimer[BOARD_CAN_COUNT];
   struct Watchdog *watchdog;
 
   struct Indicator *error;
-  struct Indicator *status;
+  struct Indicator *status[BOARD_CAN_COUNT];
   struct ProxyHub *hub;
 
   struct MemoryPackage memoryPackage;
@@ -6,6 +6,7 @@
 
 #include "board_shared.h"
 #include "version.h"
+#include <assert.h>
 #include <dpm/memory/m24.h>
 #include <halm/core/cortex/systick.h>
 #include <halm/delay.h>
@@ -199,17 +200,26 @@ void boardSetupLowPriorityWQ(void)
   WQ_LP = init(WorkQueueIrq, &wqConfig);
 }
 /*----------------------------------------------------------------------------*/
-struct Interface *boardMakeCan(void)
+struct Interface *boardMakeCan(struct Timer *timer, size_t index)
 {
-  static const struct CanConfig canConfig = {
+  static const PinNumber canPins[BOARD_CAN_COUNT][2] = {
+      {PIN(PORT_3, 1), PIN(PORT_3, 2)},
+      {PIN(PORT_4, 9), PIN(PORT_4, 8)}
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+
+  /* Timer is used for timestamping of received frames */
+  const struct CanConfig canConfig = {
+      .timer = timer,
       .rate = 10000,
       .rxBuffers = 32,
       /* TX buffer count should be at least SERIALIZED_QUEUE_SIZE */
       .txBuffers = 32,
-      .rx = PIN(PORT_3, 1),
-      .tx = PIN(PORT_3, 2),
+      .rx = canPins[index][0],
+      .tx = canPins[index][1],
       .priority = PRI_CAN,
-      .channel = 0
+      .channel = (uint8_t)index
   };
 
   return init(Can, &canConfig);
@@ -231,6 +241,25 @@ struct Timer *boardMakeEventTimer(void)
   return init(SysTick, &(struct SysTickConfig){PRI_TIMER});
 }
 /*----------------------------------------------------------------------------*/
+struct Timer *boardMakeJobTimer(size_t index)
+{
+  /* Each port needs its own timer for cyclic jobs */
+  static const struct GpTimerConfig jobTimerConfigs[BOARD_CAN_COUNT] = {
+      {
+          .frequency = 1000000,
+          .priority = PRI_TIMER,
+          .channel = 2
+      }, {
+          .frequency = 1000000,
+          .priority = PRI_TIMER,
+          .channel = 3
+      }
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+  return init(GpTimer, &jobTimerConfigs[index]);
+}
+/*----------------------------------------------------------------------------*/
 struct Timer *boardMakeMemoryTimer(void)
 {
   static const struct GpTimerConfig eepromTimerConfig = {
@@ -255,18 +284,26 @@ struct Interface *boardMakeI2C(void)
   return init(I2C, &i2cConfig);
 }
 /*----------------------------------------------------------------------------*/
-struct Interface *boardMakeSerial(struct Usb *usb)
+struct Interface *boardMakeSerial(struct Usb *usb, size_t index)
 {
+  /* Interrupt, bulk OUT and bulk IN endpoints of each CDC function */
+  static const uint8_t cdcEndpoints[BOARD_CAN_COUNT][3] = {
+      {0x81, 0x02, 0x82},
+      {0x83, 0x04, 0x84}
+  };
+
+  assert(index < BOARD_CAN_COUNT);
+
   /* CDC */
   const struct CdcAcmConfig config = {
       .device = usb,
       .rxBuffers = 4,
-      .txBuffers = 4,
+      .txBuffers = 8,
 
       .endpoints = {
-          .interrupt = 0x81,
-          .rx = 0x02,
-          .tx = 0x82
+          .interrupt = cdcEndpoints[index][0],
+          .rx = cdcEndpoints[index][1],
+          .tx = cdcEndpoints[index][2]
       }
   };
 
@@ -0,0 +1,80 @@
+/*
+ * core/batch_policy.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "batch_policy.h"
+/*----------------------------------------------------------------------------*/
+bool batchPolicyCheck(struct BatchPolicy *policy, size_t available,
+    uint32_t now)
+{
+  if (!policy->deadline)
+    return true;
+  if (!available)
+    return false;
+
+  if (!policy->pending)
+  {
+    policy->pending = true;
+    policy->started = now;
+  }
+
+  return available * policy->record >= policy->budget
+      || now - policy->started >= policy->deadline;
+}
+/*----------------------------------------------------------------------------*/
+void batchPolicyDisable(struct BatchPolicy *policy)
+{
+  policy->deadline = 0;
+  policy->budget = 0;
+  policy->pending = false;
+}
+/*----------------------------------------------------------------------------*/
+void batchPolicyEnable(struct BatchPolicy *policy, uint32_t deadline,
+    size_t record, uint32_t now)
+{
+  /* Start with a full packet, the budget adapts after the first flush */
+  policy->deadline = deadline;
+  policy->flushed = now;
+  policy->budget = SERIAL_MTU;
+  policy->record = (uint16_t)record;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t batchPolicyRemaining(const struct BatchPolicy *policy, uint32_t now)
+{
+  if (!policy->pending)
+    return 0;
+
+  /* Time left until the deadline of the oldest pending frame */
+  const uint32_t elapsed = now - policy->started;
+
+  return elapsed < policy->deadline ? policy->deadline - elapsed : 0;
+}
+/*----------------------------------------------------------------------------*/
+void batchPolicyUpdate(struct BatchPolicy *policy, size_t length,
+    size_t count, size_t available, uint32_t now)
+{
+  /* Frames left after the flush start a new batch */
+  policy->pending = available > 0;
+  if (policy->pending)
+    policy->started = now;
+
+  if (!count)
+    return;
+
+  const uint32_t interval = now - policy->flushed;
+  const uint32_t record = MAX(length / count, 1);
+  uint32_t expected = SERIAL_MTU;
+
+  policy->flushed = now;
+
+  /* Bytes expected to arrive within the deadline at the observed rate */
+  if (interval > policy->deadline)
+    expected = (uint32_t)((uint64_t)length * policy->deadline / interval);
+  expected = MIN(MAX(expected, record), SERIAL_MTU);
+
+  /* Exponential smoothing with a weight of 1/4 */
+  policy->record = (uint16_t)((policy->record * 3 + record) / 4);
+  policy->budget = (uint16_t)((policy->budget * 3 + expected) / 4);
+}
@@ -0,0 +1,39 @@
+/*
+ * core/batch_policy.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_BATCH_POLICY_H_
+#define CORE_BATCH_POLICY_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+struct BatchPolicy
+{
+  /* Flush deadline in timer ticks, zero when batching is disabled */
+  uint32_t deadline;
+  /* Timer value when the oldest pending frame was noticed */
+  uint32_t started;
+  /* Timer value of the previous flush */
+  uint32_t flushed;
+  /* Byte budget adapted to the observed traffic */
+  uint16_t budget;
+  /* Smoothed length of an encoded frame */
+  uint16_t record;
+  /* Received frames are waiting for the flush */
+  bool pending;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool batchPolicyCheck(struct BatchPolicy *, size_t, uint32_t);
+void batchPolicyDisable(struct BatchPolicy *);
+void batchPolicyEnable(struct BatchPolicy *, uint32_t, size_t, uint32_t);
+uint32_t batchPolicyRemaining(const struct BatchPolicy *, uint32_t);
+void batchPolicyUpdate(struct BatchPolicy *, size_t, size_t, size_t,
+    uint32_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_BATCH_POLICY_H_ */
@@ -0,0 +1,105 @@
+/*
+ * core/bus_load.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bus_load.h"
+/*----------------------------------------------------------------------------*/
+static uint64_t sumBuckets(const uint32_t *, size_t, size_t);
+/*----------------------------------------------------------------------------*/
+static uint64_t sumBuckets(const uint32_t *buckets, size_t current,
+    size_t count)
+{
+  uint64_t sum = 0;
+  size_t index = current;
+
+  /* Complete buckets are summed starting from the most recent one */
+  while (count--)
+  {
+    index = index ? index - 1 : BUS_LOAD_BUCKETS;
+    sum += buckets[index];
+  }
+
+  return sum;
+}
+/*----------------------------------------------------------------------------*/
+void busLoadAdd(struct BusLoad *meter, const struct ProxyMessage *message)
+{
+  uint32_t dataPhaseLength;
+
+  meter->nominal[meter->current] += calcStuffedLength(message,
+      &dataPhaseLength);
+#ifdef CONFIG_CAN_FD
+  meter->data[meter->current] += dataPhaseLength;
+#endif
+}
+/*----------------------------------------------------------------------------*/
+uint32_t busLoadAdvance(struct BusLoad *meter, uint32_t now)
+{
+  const uint32_t elapsed = (now - meter->reference) / meter->period;
+  const uint32_t cleared = MIN(elapsed, BUS_LOAD_BUCKETS + 1);
+
+  for (uint32_t i = 0; i < cleared; ++i)
+  {
+    meter->current = meter->current < BUS_LOAD_BUCKETS ?
+        meter->current + 1 : 0;
+
+    meter->nominal[meter->current] = 0;
+#ifdef CONFIG_CAN_FD
+    meter->data[meter->current] = 0;
+#endif
+  }
+
+  meter->reference += elapsed * meter->period;
+  meter->filled = MIN(meter->filled + elapsed, BUS_LOAD_BUCKETS);
+
+  return elapsed;
+}
+/*----------------------------------------------------------------------------*/
+void busLoadGet(const struct BusLoad *meter, uint32_t rate,
+    uint32_t dataRate, uint16_t *loads)
+{
+  static const size_t windows[BUS_LOAD_WINDOWS] = {1, 10, BUS_LOAD_BUCKETS};
+
+  for (size_t i = 0; i < BUS_LOAD_WINDOWS; ++i)
+  {
+    /* Windows are shortened until enough buckets are collected */
+    const size_t count = MIN(windows[i], meter->filled);
+
+    if (!count || !rate)
+    {
+      loads[i] = 0;
+      continue;
+    }
+
+    /* Bus time in microseconds, each bucket is 100000 us long */
+    uint64_t busy = sumBuckets(meter->nominal, meter->current, count)
+        * 1000000 / rate;
+
+#ifdef CONFIG_CAN_FD
+    busy += sumBuckets(meter->data, meter->current, count) * 1000000
+        / (dataRate ? dataRate : rate);
+#else
+    (void)dataRate;
+#endif
+
+    loads[i] = (uint16_t)MIN(busy / (count * 10), BUS_LOAD_MAX);
+  }
+}
+/*----------------------------------------------------------------------------*/
+void busLoadInit(struct BusLoad *meter, uint32_t now, uint32_t period)
+{
+  for (size_t i = 0; i <= BUS_LOAD_BUCKETS; ++i)
+  {
+    meter->nominal[i] = 0;
+#ifdef CONFIG_CAN_FD
+    meter->data[i] = 0;
+#endif
+  }
+
+  meter->reference = now;
+  meter->period = period;
+  meter->current = 0;
+  meter->filled = 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * core/bus_load.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_BUS_LOAD_H_
+#define CORE_BUS_LOAD_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+/* Number of complete buckets, each bucket covers 100 ms */
+#define BUS_LOAD_BUCKETS  100
+/* Number of measurement windows: 100 ms, 1 s and 10 s */
+#define BUS_LOAD_WINDOWS  3
+/* Load value of the fully utilized bus, load is measured in 0.01 % units */
+#define BUS_LOAD_MAX      10000
+
+struct BusLoad
+{
+  /* Bits of the arbitration phase, including the current bucket */
+  uint32_t nominal[BUS_LOAD_BUCKETS + 1];
+#ifdef CONFIG_CAN_FD
+  /* Bits of the data phase of frames with bit rate switching */
+  uint32_t data[BUS_LOAD_BUCKETS + 1];
+#endif
+
+  /* Timer value at the beginning of the current bucket */
+  uint32_t reference;
+  /* Timer ticks per bucket */
+  uint32_t period;
+  /* Index of the current bucket */
+  size_t current;
+  /* Number of complete buckets */
+  size_t filled;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void busLoadAdd(struct BusLoad *, const struct ProxyMessage *);
+uint32_t busLoadAdvance(struct BusLoad *, uint32_t);
+void busLoadGet(const struct BusLoad *, uint32_t, uint32_t, uint16_t *);
+void busLoadInit(struct BusLoad *, uint32_t, uint32_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_BUS_LOAD_H_ */
@@ -4,18 +4,44 @@
  * Project is distributed under the terms of the GNU General Public License v3.0
  */
 
+#include "batch_policy.h"
+#include "bus_load.h"
 #include "can_proxy.h"
 #include "can_proxy_defs.h"
+#include "change_cache.h"
+#include "filter_bank.h"
+#include "heavy_hitters.h"
 #include "helpers.h"
+#include "id_filter.h"
 #include "indicator.h"
+#include "job_wheel.h"
+#include "latency_histogram.h"
+#include "output_ring.h"
 #include "settings_project.h"
 #include "system.h"
+#include "traffic_stats.h"
 #include "version.h"
+#include "work_profile.h"
 #include <halm/generic/can.h>
 #include <halm/generic/serial.h>
 #include <halm/generic/work_queue.h>
+#include <halm/irq.h>
 #include <assert.h>
+#include <stdlib.h>
 /*----------------------------------------------------------------------------*/
+#ifdef ENABLE_LATENCY
+/* Frames of several batches may wait in the output ring with overload mode */
+#  define LATENCY_QUEUE_SIZE (SERIALIZED_BATCH_FRAMES * 2)
+
+struct LatencySample
+{
+  /* Reception time of the frame in chrono timer ticks */
+  uint32_t stamp;
+  /* Stream position of the end of the batch that contains the frame */
+  uint32_t end;
+};
+#endif
+
 struct CanProxy
 {
   struct Entity base;
@@ -28,6 +54,12 @@ struct CanProxy
   CanProxyCallback callback;
   void *argument;
 
+  /* Dictionary of the delta stream, allocated when the stream is enabled */
+  struct DeltaDictionary *dictionary;
+  /* Serialized data not yet accepted by the serial interface */
+  struct OutputRing output;
+
+  enum CanProxyFormat format;
   enum CanProxyMode mode;
   enum CanProxyNumber number;
   bool blocking;
@@ -35,40 +67,306 @@ struct CanProxy
   struct
   {
     size_t position;
-    char arena[SERIALIZED_FRAME_MTU + 1];
+    char arena[COMMAND_MTU];
     bool skip;
   } parser;
 
+  struct
+  {
+    uint32_t divisor;
+    enum TimestampFormat format;
+  } timestamp;
+
+  struct
+  {
+    uint16_t accepted;
+    uint16_t rejected;
+    bool coalesced;
+  } acks;
+
+  struct
+  {
+    /* Periodic frames, allocated when the first frame is added */
+    struct JobWheel *wheel;
+    struct Timer *timer;
+    /* Chrono timer value at the beginning of the current tick */
+    uint32_t reference;
+    /* Chrono timer ticks per millisecond */
+    uint32_t divisor;
+    /* Milliseconds since the wheel was created */
+    uint32_t time;
+    /* Job timer ticks per millisecond */
+    uint32_t tick;
+    /* Current period of the job timer, zero when the timer is stopped */
+    uint32_t overflow;
+  } jobs;
+
+  struct
+  {
+    /* Payload cache of the on-change mode, allocated when it is enabled */
+    struct ChangeCache *cache;
+    /* Chrono timer ticks per millisecond */
+    uint32_t divisor;
+    /* Frames suppressed since the mode was enabled */
+    uint32_t suppressed;
+    /* Refresh period in milliseconds, zero when disabled */
+    uint16_t period;
+  } changes;
+
+  struct
+  {
+    /* Per-identifier statistics, allocated when they are enabled */
+    struct TrafficStats *table;
+    /* Heavy-hitter sketch, allocated when it is enabled */
+    struct HeavyHitters *hitters;
+    /* Chrono timer ticks per microsecond */
+    uint32_t divisor;
+  } stats;
+
+  struct
+  {
+    /* Acceptance filter, allocated when the first rule is added */
+    struct IdFilter *rules;
+    /* Optional hardware filter of the controller */
+    const struct FilterBankLayout *layout;
+    /* Compiled hardware filter, allocated when it is programmed first time */
+    struct FilterBank *bank;
+    bool enabled;
+    /* Frames should be checked by the software stage */
+    bool software;
+  } filter;
+
+  struct
+  {
+    /* Bus load meter, allocated when it is enabled */
+    struct BusLoad *meter;
+    /* Buckets closed since the last streamed report */
+    uint32_t elapsed;
+    /* Streaming interval in buckets, zero when streaming is disabled */
+    uint8_t interval;
+  } load;
+
+  struct
+  {
+    /* Frames received from the bus and frames written to the controller */
+    uint32_t received;
+    uint32_t transmitted;
+    /* Event counters */
+    uint32_t canOverruns;
+    uint32_t serialErrors;
+    uint32_t serialOverruns;
+    /* Driver counters at the time of the last status read */
+    uint32_t overruns;
+    uint32_t errors;
+    /* Latched status flags */
+    uint8_t flags;
+  } status;
+
+  struct
+  {
+    /* Sequence number of the next forwarded frame */
+    uint16_t next;
+    bool enabled;
+  } sequence;
+
+  struct
+  {
+    /* Must-deliver identifiers, allocated when the first rule is added */
+    struct IdFilter *rules;
+    /* Dropped frames of the must-deliver and low-priority classes */
+    uint32_t dropped[2];
+    /* Drops not yet reported with a marker record */
+    uint32_t unreported[2];
+    bool enabled;
+  } overload;
+
+  struct
+  {
+    /* Deadline and adaptive byte budget of received frames */
+    struct BatchPolicy policy;
+    /* Serialized frames of the current batch */
+    char buffer[SERIALIZED_BATCH_SIZE];
+    /* Chrono timer ticks per microsecond */
+    uint32_t divisor;
+    /* Deadline in microseconds */
+    uint16_t period;
+  } batch;
+
+  struct
+  {
+    /* Handler profile, allocated when profiling is enabled */
+    struct WorkProfile *profile;
+    /* Chrono timer ticks per microsecond */
+    uint32_t divisor;
+  } work;
+
+#ifdef ENABLE_LATENCY
+  struct
+  {
+    /* Time from reception of frames to the serial write */
+    struct LatencyHistogram histogram;
+    /* Frames serialized but not yet accepted by the serial interface */
+    struct LatencySample queue[LATENCY_QUEUE_SIZE];
+    /* Bytes accepted by the serial interface, wraps around */
+    uint32_t sent;
+    /* Position of the oldest sample and number of samples in the queue */
+    uint16_t head;
+    uint16_t count;
+    /* Chrono timer ticks per microsecond */
+    uint32_t divisor;
+  } latency;
+#endif
+
   struct
   {
     bool can;
+    bool jobs;
     bool serial;
   } events;
 };
+
+struct GroupSettings
+{
+  uint8_t flags;
+  uint8_t length;
+};
+
+/* Frame groups of the test message sequence */
+static const struct GroupSettings testGroupSettings[] = {
+    /* Standard frames with empty data field */
+    {0, 0},
+    /* Standard frames with 64-bit data field */
+    {0, 8},
+    /* Extended frames with empty data field */
+    {CAN_EXT_ID, 0},
+    /* Extended frames with 64-bit data field */
+    {CAN_EXT_ID, 8},
+    /* Standard RTR frames */
+    {CAN_RTR, 0},
+    /* Extended RTR frames */
+    {CAN_RTR | CAN_EXT_ID, 0},
+#ifdef CONFIG_CAN_FD
+    /* Standard CAN FD frames with 512-bit data field */
+    {CAN_FD, 64},
+    /* Extended CAN FD frames with 512-bit data field */
+    {CAN_FD | CAN_EXT_ID, 64},
+    /* Standard CAN FD frames with bit rate switching */
+    {CAN_FD | CAN_BRS, 64},
+    /* Extended CAN FD frames with bit rate switching */
+    {CAN_FD | CAN_BRS | CAN_EXT_ID, 64}
+#endif
+};
+
+static_assert(BIN_MAX_LENGTH <= COMMAND_MTU, "Incorrect arena size");
+static_assert(BIN_DROPS_LENGTH <= RESPONSE_MTU, "Incorrect marker size");
+static_assert(CYCLIC_JOB_OFFSET + EXT_DATA_OFFSET + 2 * FRAME_DATA_MAX
+    < COMMAND_MTU, "Incorrect arena size");
+#ifdef CONFIG_CAN_FD
+static_assert(offsetof(struct ProxyMessage, id)
+    == offsetof(struct CANMessage, id), "Incorrect message layout");
+static_assert(offsetof(struct ProxyMessage, flags)
+    == offsetof(struct CANMessage, flags), "Incorrect message layout");
+static_assert(offsetof(struct ProxyMessage, length)
+    == offsetof(struct CANMessage, length), "Incorrect message layout");
+static_assert(offsetof(struct ProxyMessage, data)
+    == offsetof(struct CANMessage, data), "Incorrect message layout");
+#else
+static_assert(sizeof(struct ProxyMessage) == sizeof(struct CANStandardMessage),
+    "Incorrect message layout");
+#endif
 /*----------------------------------------------------------------------------*/
+static bool addCyclicJob(struct CanProxy *, const char *, size_t);
+static bool addFilterRule(struct CanProxy *, const char *, size_t);
+static bool addIdRule(struct IdFilter *, const char *, size_t);
+static void appendToArena(struct CanProxy *, const char *, size_t);
 static void canToSerial(struct CanProxy *);
 static void changePortMode(struct CanProxy *, enum CanProxyMode);
 static bool deserializeFrame(struct CanProxy *, const char *, size_t);
+static void executeCommand(struct CanProxy *, const char *, size_t);
+static size_t filterFrames(const struct CanProxy *, struct ProxyMessage *,
+    size_t);
+static void flushAcknowledgements(struct CanProxy *);
+static bool flushOutput(struct CanProxy *);
+static size_t getFrameMtu(const struct CanProxy *);
+static struct IdFilter *getIdFilter(struct CanProxy *);
+static uint32_t getDriverCounter(const struct CanProxy *, int);
 static uint8_t getInitialRate(const struct CanProxy *);
 static uint16_t getSerialNumber(const struct CanProxy *);
 static void handleCanEvent(void *);
+static void handleJobEvent(void *);
 static void handleSerialEvent(void *);
+static bool isBatchReady(struct CanProxy *);
+static bool isJobTickUsed(const struct CanProxy *);
+static bool isMustDeliver(const struct CanProxy *,
+    const struct ProxyMessage *);
+static bool measureCodecSpeed(struct CanProxy *, uint16_t *);
 static void mockEventHandler(void *, enum CanProxyMode, enum CanProxyEvent);
+static void notifyEvent(struct CanProxy *, enum CanProxyEvent);
 static void onCanEventCallback(void *);
+static void onJobEventCallback(void *);
 static void onSerialEventCallback(void *);
+static size_t packBusLoad(struct CanProxy *, char *);
+static size_t parseBinaryInput(struct CanProxy *, const char *, size_t);
+static size_t parseTextInput(struct CanProxy *, const char *, size_t);
 static size_t processCommand(struct CanProxy *, const char *, size_t,
     char *);
+static void profileEnqueue(struct CanProxy *, enum WorkHandler, bool);
+static void profileRun(struct CanProxy *, enum WorkHandler, uint32_t);
+#ifdef ENABLE_LATENCY
+static void queueLatency(struct CanProxy *, const uint32_t *, size_t);
+#endif
 static void readSerialInput(struct CanProxy *);
+static uint8_t readStatusFlags(struct CanProxy *);
+static bool removeCyclicJobs(struct CanProxy *, const char *, size_t);
+static void sendCounters(struct CanProxy *);
+static void sendCyclicFrame(void *, const struct ProxyMessage *);
+static void sendDropMarker(struct CanProxy *);
+static bool sendHitterPage(struct CanProxy *, const char *);
+#ifdef ENABLE_LATENCY
+static bool sendLatencyHistogram(struct CanProxy *);
+#endif
 static bool sendMessageGroup(struct CanProxy *, uint8_t, size_t, size_t);
+static bool sendStatisticsPage(struct CanProxy *, const char *);
 static bool sendTestMessages(struct CanProxy *, const char *, size_t);
-static void serializeFrames(struct CanProxy *,
-    const struct CANStandardMessage *, size_t);
+static bool sendWorkProfile(struct CanProxy *);
+static size_t serializeFrames(struct CanProxy *, char *,
+    const struct ProxyMessage *, const uint16_t *, size_t);
+static bool setAcknowledgementMode(struct CanProxy *, const char *);
+static bool setBatchingMode(struct CanProxy *, const char *, size_t);
 static bool setBlockingMode(struct CanProxy *, const char *);
-static bool setCustomRate(struct CanProxy *, const char *);
+static bool setBusLoadMode(struct CanProxy *, const char *, size_t);
+static bool setChangeMode(struct CanProxy *, const char *, size_t);
+static bool setCustomDataRate(struct CanProxy *, const char *, size_t);
+static bool setCustomRate(struct CanProxy *, const char *, size_t);
+static bool setDataRate(struct CanProxy *, uint32_t);
+static bool setFilterCode(struct CanProxy *, const char *);
+static bool setFilterMode(struct CanProxy *, const char *);
+static bool setFrameFormat(struct CanProxy *, const char *);
+static bool setHitterMode(struct CanProxy *, const char *);
 static bool setInitialRate(struct CanProxy *, const char *);
+static bool setOverloadMode(struct CanProxy *, const char *, size_t);
+static bool setPredefinedDataRate(struct CanProxy *, const char *);
 static bool setPredefinedRate(struct CanProxy *, const char *);
+static bool setProfilingMode(struct CanProxy *, const char *);
 static bool setRetransmissionMode(struct CanProxy *, const char *);
+static bool setSequenceMode(struct CanProxy *, const char *);
 static bool setSerialNumber(struct CanProxy *, const char *);
+static bool setStatisticsMode(struct CanProxy *, const char *);
+static bool setTimestampFormat(struct CanProxy *, const char *);
+static size_t shedFrames(struct CanProxy *, struct ProxyMessage *,
+    uint16_t *, size_t, size_t);
+static size_t suppressFrames(struct CanProxy *, struct ProxyMessage *,
+    size_t);
+static void updateBusLoad(struct CanProxy *, const struct ProxyMessage *,
+    size_t);
+static void updateFilterBank(struct CanProxy *);
+static uint32_t updateJobTime(struct CanProxy *);
+static void updateJobTimer(struct CanProxy *);
+#ifdef ENABLE_LATENCY
+static void updateLatency(struct CanProxy *);
+#endif
+static bool writeOutput(struct CanProxy *, const char *, size_t);
+static void writeResponse(struct CanProxy *, const char *, size_t);
 /*----------------------------------------------------------------------------*/
 static enum Result proxyInit(void *, const void *);
 static void proxyDeinit(void *);
@@ -79,29 +377,308 @@ const struct EntityClass * const CanProxy = &(const struct EntityClass){
     .deinit = proxyDeinit
 };
 /*----------------------------------------------------------------------------*/
+static bool addCyclicJob(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  static const char types[] = "bBdDrRtT";
+
+  struct ProxyMessage message;
+
+  if (proxy->chrono == NULL || proxy->jobs.timer == NULL)
+    return false;
+  if (length <= CYCLIC_JOB_OFFSET
+      || memchr(types, request[CYCLIC_JOB_OFFSET], sizeof(types) - 1) == NULL)
+  {
+    return false;
+  }
+  if (!unpackFrame(request + CYCLIC_JOB_OFFSET, length - CYCLIC_JOB_OFFSET,
+      &message))
+  {
+    return false;
+  }
+
+  if (proxy->jobs.wheel == NULL)
+  {
+    const uint32_t divisor = timerGetFrequency(proxy->chrono) / 1000;
+
+    if (!divisor)
+      return false;
+
+    proxy->jobs.wheel = malloc(sizeof(struct JobWheel));
+    if (proxy->jobs.wheel == NULL)
+      return false;
+
+    proxy->jobs.divisor = divisor;
+    proxy->jobs.reference = timerGetValue(proxy->chrono);
+    proxy->jobs.time = 0;
+    jobWheelInit(proxy->jobs.wheel, 0);
+  }
+  else
+  {
+    /* Process elapsed ticks before the new job is scheduled */
+    jobWheelAdvance(proxy->jobs.wheel, updateJobTime(proxy), sendCyclicFrame,
+        proxy);
+  }
+
+  const size_t index = (hexToBin(request[1]) << 4) | hexToBin(request[2]);
+  const uint16_t period = inPlaceHexToBin4(request + 3);
+  const uint16_t count = inPlaceHexToBin4(request + 7);
+  const uint16_t phase = inPlaceHexToBin4(request + 11);
+
+  if (!jobWheelAdd(proxy->jobs.wheel, index, &message, period, count, phase))
+    return false;
+
+  updateJobTimer(proxy);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool addFilterRule(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  struct IdFilter * const filter = getIdFilter(proxy);
+
+  if (filter == NULL)
+    return false;
+
+  if (length == 1)
+  {
+    /* Remove all rules, acceptance code and mask included */
+    idFilterClear(filter);
+    updateFilterBank(proxy);
+    return true;
+  }
+
+  const bool added = addIdRule(filter, request, length);
+
+  if (added)
+    updateFilterBank(proxy);
+  return added;
+}
+/*----------------------------------------------------------------------------*/
+static bool addIdRule(struct IdFilter *filter, const char *request,
+    size_t length)
+{
+  /* Command (1) + Type (1) + Two identifiers (3 or 8 each) */
+  const bool extended = request[1] == 'M' || request[1] == 'R';
+  uint32_t first;
+  uint32_t second;
+
+  if (extended)
+  {
+    if (length != 2 + 8 * 2)
+      return false;
+
+    first = ((uint32_t)inPlaceHexToBin4(request + 2) << 16)
+        | inPlaceHexToBin4(request + 6);
+    second = ((uint32_t)inPlaceHexToBin4(request + 10) << 16)
+        | inPlaceHexToBin4(request + 14);
+  }
+  else
+  {
+    if (length != 2 + 3 * 2)
+      return false;
+
+    first = (hexToBin(request[2]) << 8) | (hexToBin(request[3]) << 4)
+        | hexToBin(request[4]);
+    second = (hexToBin(request[5]) << 8) | (hexToBin(request[6]) << 4)
+        | hexToBin(request[7]);
+  }
+
+  switch (request[1])
+  {
+    case 'm':
+    case 'M':
+      return idFilterAddMask(filter, extended, first, second);
+
+    case 'r':
+    case 'R':
+      return idFilterAddRange(filter, extended, first, second);
+
+    default:
+      return false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void appendToArena(struct CanProxy *proxy, const char *input,
+    size_t length)
+{
+  if (proxy->parser.skip)
+    return;
+
+  if (length <= sizeof(proxy->parser.arena) - proxy->parser.position)
+  {
+    memcpy(proxy->parser.arena + proxy->parser.position, input, length);
+    proxy->parser.position += length;
+  }
+  else
+    proxy->parser.skip = true;
+}
+/*----------------------------------------------------------------------------*/
 static void canToSerial(struct CanProxy *proxy)
 {
-  struct CANStandardMessage frames[SERIALIZED_QUEUE_SIZE];
-  size_t capacity;
+  struct ProxyMessage frames[SERIALIZED_QUEUE_SIZE];
+  uint16_t sequences[ARRAY_SIZE(frames)];
+#ifdef ENABLE_LATENCY
+  /* Reception time is kept before timestamps are converted */
+  uint32_t stamps[SERIALIZED_BATCH_FRAMES];
+#endif
+  char * const buffer = proxy->batch.buffer;
+  const size_t mtu = getFrameMtu(proxy);
+  size_t available;
+  size_t length = 0;
+  size_t processed = 0;
+  size_t total = 0;
+
+  /*
+   * Frames are left in the receive queue of the controller until
+   * previously serialized data is accepted by the serial interface.
+   * With the overload policy enabled, the queue is drained instead and
+   * frames that do not fit into the output ring are dropped.
+   */
+  const bool overloaded = !flushOutput(proxy);
+
+  if (overloaded)
+  {
+    if (!proxy->overload.enabled)
+      return;
 
-  ifGetParam(proxy->serial, IF_TX_AVAILABLE, &capacity);
-  capacity /= SERIALIZED_FRAME_MTU;
-  capacity = MIN(capacity, ARRAY_SIZE(frames));
+    /* Space for the marker record is reserved */
+    const size_t space = OUTPUT_RING_SIZE - proxy->output.count;
+
+    available = space > RESPONSE_MTU ?
+        MIN(SERIALIZED_BATCH_SIZE, space - RESPONSE_MTU) : 0;
+  }
+  else
+  {
+    /*
+     * The batch is limited by the free space of the serial interface,
+     * at least one frame is read and its remainder is kept in the ring.
+     */
+    ifGetParam(proxy->serial, IF_TX_AVAILABLE, &available);
+    available = MIN(MAX(available, mtu), SERIALIZED_BATCH_SIZE);
+  }
 
-  if (capacity > 0)
+  /*
+   * Frames are packed with their exact encoded length, the receive queue
+   * is drained while the worst-case frame still fits into the free space.
+   */
+  while (processed < SERIALIZED_BATCH_FRAMES)
   {
-    const size_t count = ifRead(proxy->can, frames,
-        capacity * sizeof(struct CANStandardMessage));
+    const size_t room = (available - length) / mtu;
+    size_t capacity = overloaded ? ARRAY_SIZE(frames) : room;
+
+    capacity = MIN(capacity, ARRAY_SIZE(frames));
+    capacity = MIN(capacity, SERIALIZED_BATCH_FRAMES - processed);
+
+    if (!capacity)
+      break;
+
+    size_t count = ifRead(proxy->can, frames,
+        capacity * sizeof(struct ProxyMessage))
+        / sizeof(struct ProxyMessage);
+
+    if (!count)
+      break;
+
+    processed += count;
+    proxy->status.received += count;
+
+    /* Statistics include frames that are not forwarded to the host */
+    if (proxy->load.meter != NULL)
+      updateBusLoad(proxy, frames, count);
+    if (proxy->stats.table != NULL)
+    {
+      for (size_t i = 0; i < count; ++i)
+        trafficStatsUpdate(proxy->stats.table, frames + i);
+    }
+    if (proxy->stats.hitters != NULL)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        const uint32_t id = (frames[i].flags & CAN_EXT_ID) ?
+            (frames[i].id | TRAFFIC_STATS_EXT) : frames[i].id;
+
+        heavyHittersUpdate(proxy->stats.hitters, id);
+      }
+    }
+
+    /* Rejected and suppressed frames produce no output */
+    if (proxy->filter.software)
+      count = filterFrames(proxy, frames, count);
+    if (proxy->changes.cache != NULL)
+      count = suppressFrames(proxy, frames, count);
+
+    /* Frames dropped after this point leave gaps in the sequence */
+    for (size_t i = 0; i < count; ++i)
+      sequences[i] = proxy->sequence.next++;
 
-    if (count > 0)
+    if (overloaded)
+      count = shedFrames(proxy, frames, sequences, count, room);
+
+    if (!count)
+      continue;
+
+#ifdef ENABLE_LATENCY
+    for (size_t i = 0; i < count; ++i)
+      stamps[total + i] = frames[i].timestamp;
+#endif
+
+    if (proxy->timestamp.format != TIMESTAMP_NONE)
     {
-      serializeFrames(proxy, frames, count / sizeof(struct CANStandardMessage));
+      /* Convert timer ticks to milliseconds or microseconds */
+      for (size_t i = 0; i < count; ++i)
+        frames[i].timestamp /= proxy->timestamp.divisor;
+
+      if (proxy->timestamp.format == TIMESTAMP_16_BIT)
+      {
+        /* Millisecond timestamps wrap around every minute */
+        for (size_t i = 0; i < count; ++i)
+          frames[i].timestamp %= 60000;
+      }
     }
+
+    length += serializeFrames(proxy, buffer + length, frames, sequences,
+        count);
+    total += count;
+  }
+
+  /* Marker precedes frames received after the gap */
+  if (proxy->overload.unreported[0] || proxy->overload.unreported[1])
+    sendDropMarker(proxy);
+
+  if (length > 0)
+  {
+    /* The batch fits into the serial interface and the output ring */
+    writeOutput(proxy, buffer, length);
+    notifyEvent(proxy, SLCAN_EVENT_RX);
+
+#ifdef ENABLE_LATENCY
+    /* Frames are sampled when the end of the batch leaves the ring */
+    queueLatency(proxy, stamps, total);
+#endif
+  }
+
+  if (proxy->batch.policy.deadline)
+  {
+    size_t waiting;
+
+    ifGetParam(proxy->can, IF_RX_AVAILABLE, &waiting);
+    batchPolicyUpdate(&proxy->batch.policy, length, total, waiting,
+        timerGetValue(proxy->chrono));
+
+    /* Wakeup is cancelled or moved to the deadline of the leftover frames */
+    updateJobTimer(proxy);
   }
 }
 /*----------------------------------------------------------------------------*/
 static void changePortMode(struct CanProxy *proxy, enum CanProxyMode mode)
 {
+  /*
+   * Output of the previous session is kept and sent before the response
+   * to the command, records and queued responses are never cut.
+   */
+  flushOutput(proxy);
+
   switch (mode)
   {
     case SLCAN_MODE_ACTIVE:
@@ -117,6 +694,10 @@ static void changePortMode(struct CanProxy *proxy, enum CanProxyMode mode)
       break;
   }
 
+  /* Driver may bypass the hardware filter when the mode is changed */
+  if (proxy->filter.bank != NULL)
+    updateFilterBank(proxy);
+
   proxy->mode = mode;
   proxy->callback(proxy->argument, mode, SLCAN_EVENT_NONE);
 }
@@ -124,28 +705,153 @@ static void changePortMode(struct CanProxy *proxy, enum CanProxyMode mode)
 static bool deserializeFrame(struct CanProxy *proxy, const char *request,
     size_t length)
 {
-  struct CANStandardMessage message;
+  struct ProxyMessage message;
 
   if (unpackFrame(request, length, &message))
   {
     if (ifWrite(proxy->can, &message, sizeof(message)) == sizeof(message))
     {
-      proxy->callback(proxy->argument, proxy->mode, SLCAN_EVENT_TX);
+      if (proxy->load.meter != NULL)
+        updateBusLoad(proxy, &message, 1);
+
+      notifyEvent(proxy, SLCAN_EVENT_TX);
       return true;
     }
     else
     {
-      proxy->callback(proxy->argument, proxy->mode, SLCAN_EVENT_CAN_OVERRUN);
+      notifyEvent(proxy, SLCAN_EVENT_CAN_OVERRUN);
       return false;
     }
   }
   else
   {
-    proxy->callback(proxy->argument, proxy->mode, SLCAN_EVENT_SERIAL_ERROR);
+    notifyEvent(proxy, SLCAN_EVENT_SERIAL_ERROR);
     return false;
   }
 }
 /*----------------------------------------------------------------------------*/
+static void executeCommand(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  char response[RESPONSE_MTU];
+  const size_t responseLength = processCommand(proxy, request, length,
+      response);
+
+  if (responseLength > 0)
+    writeResponse(proxy, response, responseLength);
+}
+/*----------------------------------------------------------------------------*/
+static size_t filterFrames(const struct CanProxy *proxy,
+    struct ProxyMessage *frames, size_t count)
+{
+  const struct IdFilter * const filter = proxy->filter.rules;
+  size_t accepted = 0;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const bool extended = (frames[i].flags & CAN_EXT_ID) != 0;
+
+    if (idFilterMatch(filter, frames[i].id, extended))
+    {
+      if (accepted != i)
+        frames[accepted] = frames[i];
+      ++accepted;
+    }
+  }
+
+  return accepted;
+}
+/*----------------------------------------------------------------------------*/
+static void flushAcknowledgements(struct CanProxy *proxy)
+{
+  if (proxy->acks.accepted || proxy->acks.rejected)
+  {
+    char response[1 + 4 * 2 + 1];
+
+    response[0] = 'a';
+    inPlaceBinToHex4(response + 1, proxy->acks.accepted);
+    inPlaceBinToHex4(response + 5, proxy->acks.rejected);
+    response[9] = '\r';
+    writeResponse(proxy, response, sizeof(response));
+
+    proxy->acks.accepted = 0;
+    proxy->acks.rejected = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool flushOutput(struct CanProxy *proxy)
+{
+  while (proxy->output.count)
+  {
+    const char *data;
+    const size_t length = outputRingPeek(&proxy->output, &data);
+    const size_t written = ifWrite(proxy->serial, data, length);
+
+    outputRingSkip(&proxy->output, written);
+#ifdef ENABLE_LATENCY
+    proxy->latency.sent += written;
+#endif
+
+    if (written != length)
+      break;
+  }
+
+#ifdef ENABLE_LATENCY
+  if (proxy->latency.count)
+    updateLatency(proxy);
+#endif
+
+  return !proxy->output.count;
+}
+/*----------------------------------------------------------------------------*/
+static size_t getFrameMtu(const struct CanProxy *proxy)
+{
+  if (proxy->format == SLCAN_FORMAT_BINARY)
+    return BIN_MAX_LENGTH + (proxy->sequence.enabled ? SEQ_BIN_LENGTH : 0);
+
+  /* Keyframes of the delta stream have a record header before the frame */
+  size_t offset = proxy->format == SLCAN_FORMAT_DELTA ? DELTA_KEY_OFFSET : 0;
+
+  if (proxy->sequence.enabled)
+    offset += SEQ_TEXT_LENGTH;
+
+  switch (proxy->timestamp.format)
+  {
+    case TIMESTAMP_NONE:
+      return SERIALIZED_FRAME_MTU - 8 + offset;
+
+    case TIMESTAMP_16_BIT:
+      return SERIALIZED_FRAME_MTU - 4 + offset;
+
+    default:
+      return SERIALIZED_FRAME_MTU + offset;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static struct IdFilter *getIdFilter(struct CanProxy *proxy)
+{
+  if (proxy->filter.rules == NULL)
+  {
+    proxy->filter.rules = malloc(sizeof(struct IdFilter));
+
+    if (proxy->filter.rules != NULL)
+      idFilterClear(proxy->filter.rules);
+  }
+
+  return proxy->filter.rules;
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t getDriverCounter(const struct CanProxy *proxy, int parameter)
+{
+  uint32_t value;
+
+  /* Counters are available only when they are enabled in the driver */
+  if (ifGetParam(proxy->can, parameter, &value) == E_OK)
+    return value;
+  else
+    return 0;
+}
+/*----------------------------------------------------------------------------*/
 static uint8_t getInitialRate(const struct CanProxy *proxy)
 {
   uint8_t value = 0xF;
@@ -172,6 +878,8 @@ static uint16_t getSerialNumber(const struct CanProxy *proxy)
 static void handleCanEvent(void *argument)
 {
   struct CanProxy * const proxy = argument;
+  const bool profiled = proxy->work.profile != NULL;
+  const uint32_t started = profiled ? timerGetValue(proxy->chrono) : 0;
   size_t rxAvailable;
   size_t txAvailable;
 
@@ -179,7 +887,7 @@ static void handleCanEvent(void *argument)
   ifGetParam(proxy->can, IF_RX_AVAILABLE, &rxAvailable);
   ifGetParam(proxy->can, IF_TX_AVAILABLE, &txAvailable);
 
-  if (rxAvailable > 0)
+  if (rxAvailable > 0 && isBatchReady(proxy))
   {
     canToSerial(proxy);
   }
@@ -189,11 +897,53 @@ static void handleCanEvent(void *argument)
     ifSetParam(proxy->serial, IF_SERIAL_RTS, &((uint8_t){1}));
     readSerialInput(proxy);
   }
+
+  if (profiled)
+    profileRun(proxy, WORK_HANDLER_CAN, started);
+}
+/*----------------------------------------------------------------------------*/
+static void handleJobEvent(void *argument)
+{
+  struct CanProxy * const proxy = argument;
+  const bool profiled = proxy->work.profile != NULL;
+  const uint32_t started = profiled ? timerGetValue(proxy->chrono) : 0;
+
+  proxy->events.jobs = false;
+
+  if (proxy->jobs.wheel != NULL)
+  {
+    jobWheelAdvance(proxy->jobs.wheel, updateJobTime(proxy), sendCyclicFrame,
+        proxy);
+  }
+
+  if (proxy->load.interval)
+  {
+    updateBusLoad(proxy, NULL, 0);
+
+    if (proxy->load.elapsed >= proxy->load.interval)
+    {
+      char response[RESPONSE_MTU];
+
+      proxy->load.elapsed = 0;
+      writeResponse(proxy, response, packBusLoad(proxy, response));
+    }
+  }
+
+  /* Frames are flushed when the deadline expires on an idle bus */
+  if (proxy->batch.policy.pending && isBatchReady(proxy))
+    canToSerial(proxy);
+
+  updateJobTimer(proxy);
+
+  if (profiled)
+    profileRun(proxy, WORK_HANDLER_JOBS, started);
 }
 /*----------------------------------------------------------------------------*/
 static void handleSerialEvent(void *argument)
 {
   struct CanProxy * const proxy = argument;
+  const bool profiled = proxy->work.profile != NULL;
+  const uint32_t started = profiled ? timerGetValue(proxy->chrono) : 0;
   size_t rxAvailable;
   size_t txAvailable;
 
@@ -208,12 +958,191 @@ static void handleSerialEvent(void *argument)
 
   if (txAvailable > 0)
   {
-    canToSerial(proxy);
+    /* Pending output is resumed even when no frames are ready */
+    if (isBatchReady(proxy))
+      canToSerial(proxy);
+    else
+      flushOutput(proxy);
   }
+
+  if (profiled)
+    profileRun(proxy, WORK_HANDLER_SERIAL, started);
 }
 /*----------------------------------------------------------------------------*/
-static void mockEventHandler(void *, enum CanProxyMode, enum CanProxyEvent)
+static bool isBatchReady(struct CanProxy *proxy)
 {
+  struct BatchPolicy * const policy = &proxy->batch.policy;
+
+  if (!policy->deadline)
+    return true;
+
+  const bool pending = policy->pending;
+  size_t available;
+
+  ifGetParam(proxy->can, IF_RX_AVAILABLE, &available);
+
+  const bool ready = batchPolicyCheck(policy, available,
+      timerGetValue(proxy->chrono));
+
+  /* One-shot wakeup is armed when the first frame is held back */
+  if (policy->pending && !pending)
+    updateJobTimer(proxy);
+
+  return ready;
+}
+/*----------------------------------------------------------------------------*/
+static bool isJobTickUsed(const struct CanProxy *proxy)
+{
+  if (proxy->jobs.wheel != NULL && proxy->jobs.wheel->count)
+    return true;
+
+  return proxy->load.interval != 0;
+}
+/*----------------------------------------------------------------------------*/
+static bool isMustDeliver(const struct CanProxy *proxy,
+    const struct ProxyMessage *message)
+{
+  const struct IdFilter * const rules = proxy->overload.rules;
+
+  return rules != NULL && idFilterMatch(rules, message->id,
+      (message->flags & CAN_EXT_ID) != 0);
+}
+/*----------------------------------------------------------------------------*/
+static bool measureCodecSpeed(struct CanProxy *proxy, uint16_t *results)
+{
+  static const size_t rounds = 64;
+  static const size_t count = ARRAY_SIZE(testGroupSettings);
+
+  struct ProxyMessage messages[ARRAY_SIZE(testGroupSettings)];
+  char text[ARRAY_SIZE(testGroupSettings)][SERIALIZED_FRAME_MTU];
+  uint8_t binary[ARRAY_SIZE(testGroupSettings)][BIN_MAX_LENGTH];
+  size_t textLengths[ARRAY_SIZE(testGroupSettings)];
+  size_t binaryLengths[ARRAY_SIZE(testGroupSettings)];
+  struct ProxyMessage message;
+  uint32_t ticks[4];
+  uint32_t timestamp;
+
+  if (proxy->chrono == NULL)
+    return false;
+
+  /* Frame mix of the test message sequence */
+  for (size_t i = 0; i < count; ++i)
+  {
+    messages[i].timestamp = 0;
+    messages[i].id = (testGroupSettings[i].flags & CAN_EXT_ID) ?
+        0x12345678 + i : 0x123 + i;
+    messages[i].flags = testGroupSettings[i].flags;
+    messages[i].length = testGroupSettings[i].length;
+
+    for (size_t j = 0; j < ARRAY_SIZE(messages[i].data); ++j)
+      messages[i].data[j] = (uint8_t)(i + j);
+
+    textLengths[i] = packFrame(text[i], messages + i, TIMESTAMP_NONE);
+    binaryLengths[i] = packBinaryFrame(binary[i], messages + i, false);
+  }
+
+  /* Results are checked so that the calls can not be optimized out */
+  timestamp = timerGetValue(proxy->chrono);
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      char frame[SERIALIZED_FRAME_MTU];
+
+      if (packFrame(frame, messages + i, TIMESTAMP_NONE) != textLengths[i])
+        return false;
+    }
+  }
+  ticks[0] = timerGetValue(proxy->chrono) - timestamp;
+
+  timestamp = timerGetValue(proxy->chrono);
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      const size_t eol = findLineEnd(text[i], textLengths[i]);
+
+      if (!unpackFrame(text[i], eol, &message) || message.id != messages[i].id)
+        return false;
+    }
+  }
+  ticks[1] = timerGetValue(proxy->chrono) - timestamp;
+
+  timestamp = timerGetValue(proxy->chrono);
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint8_t frame[BIN_MAX_LENGTH];
+
+      if (packBinaryFrame(frame, messages + i, false) != binaryLengths[i])
+        return false;
+    }
+  }
+  ticks[2] = timerGetValue(proxy->chrono) - timestamp;
+
+  timestamp = timerGetValue(proxy->chrono);
+  for (size_t round = 0; round < rounds; ++round)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (!unpackBinaryFrame(binary[i], binaryLengths[i], &message)
+          || message.id != messages[i].id)
+      {
+        return false;
+      }
+    }
+  }
+  ticks[3] = timerGetValue(proxy->chrono) - timestamp;
+
+  /* Convert timer ticks to nanoseconds per frame */
+  const uint64_t divisor =
+      (uint64_t)timerGetFrequency(proxy->chrono) * rounds * count;
+
+  for (size_t i = 0; i < ARRAY_SIZE(ticks); ++i)
+  {
+    const uint64_t time = (uint64_t)ticks[i] * 1000000000ULL / divisor;
+    results[i] = (uint16_t)MIN(time, UINT16_MAX);
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void mockEventHandler(void *, enum CanProxyMode, enum CanProxyEvent)
+{
+}
+/*----------------------------------------------------------------------------*/
+static void notifyEvent(struct CanProxy *proxy, enum CanProxyEvent event)
+{
+  switch (event)
+  {
+    case SLCAN_EVENT_TX:
+      ++proxy->status.transmitted;
+      break;
+
+    case SLCAN_EVENT_BUS_FAULT:
+      proxy->status.flags |= STATUS_BUS_ERROR;
+      break;
+
+    case SLCAN_EVENT_CAN_OVERRUN:
+      ++proxy->status.canOverruns;
+      proxy->status.flags |= STATUS_TX_FULL;
+      break;
+
+    case SLCAN_EVENT_SERIAL_ERROR:
+      ++proxy->status.serialErrors;
+      break;
+
+    case SLCAN_EVENT_SERIAL_OVERRUN:
+      ++proxy->status.serialOverruns;
+      proxy->status.flags |= STATUS_RX_FULL;
+      break;
+
+    default:
+      break;
+  }
+
+  proxy->callback(proxy->argument, proxy->mode, event);
 }
 /*----------------------------------------------------------------------------*/
 static void onCanEventCallback(void *argument)
@@ -222,22 +1151,202 @@ static void onCanEventCallback(void *argument)
 
   if (!proxy->events.can)
   {
-    if (wqAdd(WQ_DEFAULT, handleCanEvent, argument) == E_OK)
+    const bool added = wqAdd(WQ_DEFAULT, handleCanEvent, argument) == E_OK;
+
+    if (proxy->work.profile != NULL)
+      profileEnqueue(proxy, WORK_HANDLER_CAN, added);
+    if (added)
       proxy->events.can = true;
   }
 }
 /*----------------------------------------------------------------------------*/
+static void onJobEventCallback(void *argument)
+{
+  struct CanProxy * const proxy = argument;
+
+  if (!proxy->events.jobs)
+  {
+    const bool added = wqAdd(WQ_DEFAULT, handleJobEvent, argument) == E_OK;
+
+    if (proxy->work.profile != NULL)
+      profileEnqueue(proxy, WORK_HANDLER_JOBS, added);
+    if (added)
+      proxy->events.jobs = true;
+  }
+}
+/*----------------------------------------------------------------------------*/
 static void onSerialEventCallback(void *argument)
 {
   struct CanProxy * const proxy = argument;
 
   if (!proxy->events.serial)
   {
-    if (wqAdd(WQ_DEFAULT, handleSerialEvent, argument) == E_OK)
+    const bool added = wqAdd(WQ_DEFAULT, handleSerialEvent, argument) == E_OK;
+
+    if (proxy->work.profile != NULL)
+      profileEnqueue(proxy, WORK_HANDLER_SERIAL, added);
+    if (added)
       proxy->events.serial = true;
   }
 }
 /*----------------------------------------------------------------------------*/
+static size_t packBusLoad(struct CanProxy *proxy, char *response)
+{
+  uint16_t loads[BUS_LOAD_WINDOWS];
+  uint32_t dataRate = 0;
+  uint32_t rate;
+
+  if (ifGetParam(proxy->can, IF_RATE, &rate) != E_OK)
+    rate = 0;
+#ifdef CONFIG_CAN_FD
+  if (ifGetParam(proxy->can, IF_CAN_FD_RATE, &dataRate) != E_OK)
+    dataRate = 0;
+#endif
+
+  /* Close buckets that ended while the bus was idle */
+  updateBusLoad(proxy, NULL, 0);
+  busLoadGet(proxy->load.meter, rate, dataRate, loads);
+
+  response[0] = 'U';
+  for (size_t i = 0; i < ARRAY_SIZE(loads); ++i)
+    inPlaceBinToHex4(response + 1 + i * 4, loads[i]);
+  response[1 + ARRAY_SIZE(loads) * 4] = '\r';
+
+  return 2 + ARRAY_SIZE(loads) * 4;
+}
+/*----------------------------------------------------------------------------*/
+static size_t parseBinaryInput(struct CanProxy *proxy, const char *input,
+    size_t count)
+{
+  uint8_t * const arena = (uint8_t *)proxy->parser.arena;
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    const uint8_t c = (uint8_t)input[index];
+
+    if (proxy->parser.position == 0)
+    {
+      if (c == BIN_FRAME_MARKER)
+      {
+        arena[proxy->parser.position++] = c;
+      }
+      else if (c == BIN_RESET_MARKER)
+      {
+        /* Return to the text mode, remaining data is parsed as text */
+        proxy->format = SLCAN_FORMAT_TEXT;
+        writeResponse(proxy, "\r", 1);
+        return index + 1;
+      }
+
+      /* Other bytes are skipped until the beginning of the next record */
+      continue;
+    }
+
+    arena[proxy->parser.position++] = c;
+
+    const size_t expected = getBinaryFrameLength(arena[1]);
+
+    if (!expected)
+    {
+      /* Incorrect length field */
+      notifyEvent(proxy, SLCAN_EVENT_SERIAL_ERROR);
+      writeResponse(proxy, "\a", 1);
+      proxy->parser.position = 0;
+    }
+    else if (proxy->parser.position == expected)
+    {
+      struct ProxyMessage message;
+      bool sent = false;
+
+      if (unpackBinaryFrame(arena, expected, &message))
+      {
+        if (ifWrite(proxy->can, &message, sizeof(message)) == sizeof(message))
+        {
+          if (proxy->load.meter != NULL)
+            updateBusLoad(proxy, &message, 1);
+
+          notifyEvent(proxy, SLCAN_EVENT_TX);
+          sent = true;
+        }
+        else
+        {
+          notifyEvent(proxy, SLCAN_EVENT_CAN_OVERRUN);
+        }
+      }
+      else
+      {
+        notifyEvent(proxy, SLCAN_EVENT_SERIAL_ERROR);
+      }
+
+      if (!proxy->acks.coalesced)
+        writeResponse(proxy, sent ? "\r" : "\a", 1);
+      else if (sent)
+        proxy->acks.accepted += proxy->acks.accepted < UINT16_MAX;
+      else
+      {
+        /* Rejected frames are still reported individually */
+        proxy->acks.rejected += proxy->acks.rejected < UINT16_MAX;
+        writeResponse(proxy, "\a", 1);
+      }
+
+      proxy->parser.position = 0;
+    }
+  }
+
+  return count;
+}
+/*----------------------------------------------------------------------------*/
+static size_t parseTextInput(struct CanProxy *proxy, const char *input,
+    size_t count)
+{
+  size_t index = 0;
+
+  while (index < count)
+  {
+    const size_t eol = index + findLineEnd(input + index, count - index);
+
+    if (eol == count)
+    {
+      /* Incomplete line, keep it until the next read */
+      appendToArena(proxy, input + index, count - index);
+      return count;
+    }
+
+    if (proxy->parser.position > 0 || proxy->parser.skip)
+    {
+      /* Beginning of the line was received during previous reads */
+      appendToArena(proxy, input + index, eol - index);
+
+      if (!proxy->parser.skip)
+        executeCommand(proxy, proxy->parser.arena, proxy->parser.position);
+      else
+        writeResponse(proxy, "\a", 1);
+    }
+    else if (eol - index <= sizeof(proxy->parser.arena))
+    {
+      /* Complete line, process it directly from the input buffer */
+      executeCommand(proxy, input + index, eol - index);
+    }
+    else
+    {
+      /* Line is longer than any supported command */
+      writeResponse(proxy, "\a", 1);
+    }
+
+    proxy->parser.position = 0;
+    proxy->parser.skip = false;
+    index = eol + 1;
+
+    if (proxy->format == SLCAN_FORMAT_BINARY)
+    {
+      /* Remaining data should be handled by the binary parser */
+      break;
+    }
+  }
+
+  return index;
+}
+/*----------------------------------------------------------------------------*/
 static size_t processCommand(struct CanProxy *proxy, const char *request,
     size_t length, char *response)
 {
@@ -249,7 +1358,7 @@ static size_t processCommand(struct CanProxy *proxy, const char *request,
     case 's':
     {
       /* Custom command: set bit rate */
-      if (length >= 5 && length <= 7 && setCustomRate(proxy, request))
+      if (length >= 5 && length <= 7 && setCustomRate(proxy, request, length))
         strcpy(response, "\r");
       else
         strcpy(response, "\a");
@@ -266,15 +1375,84 @@ static size_t processCommand(struct CanProxy *proxy, const char *request,
       break;
     }
 
+    case 'y':
+    {
+      /* Custom command: set data phase bit rate */
+      if (length >= 5 && length <= 9
+          && setCustomDataRate(proxy, request, length))
+      {
+        strcpy(response, "\r");
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'Y':
+    {
+      /* Custom command: set standard data phase bit rate */
+      if (length == 2 && setPredefinedDataRate(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'b':
+    {
+      if (length == 2)
+      {
+        /* Custom command: enable or disable blocking mode */
+        if (setBlockingMode(proxy, request))
+          strcpy(response, "\r");
+        else
+          strcpy(response, "\a");
+        break;
+      }
+
+      /* CAN FD frame with bit rate switching */
+      [[fallthrough]];
+    }
+
+    case 'B':
+    {
+      if (length == 1)
+      {
+        /* Custom command: reset to bootloader */
+        resetToBootloader();
+        strcpy(response, "\a");
+        break;
+      }
+
+      /* Extended CAN FD frame with bit rate switching */
+      [[fallthrough]];
+    }
+
+    case 'd':
+    case 'D':
     case 'r':
     case 'R':
     case 't':
     case 'T':
     {
       if (deserializeFrame(proxy, request, length))
+      {
+        if (proxy->acks.coalesced)
+        {
+          /* Accepted frames are reported in the cumulative record */
+          proxy->acks.accepted += proxy->acks.accepted < UINT16_MAX;
+          return 0;
+        }
+
         strcpy(response, "z\r");
+      }
       else
+      {
+        if (proxy->acks.coalesced)
+          proxy->acks.rejected += proxy->acks.rejected < UINT16_MAX;
+
         strcpy(response, "\a");
+      }
       break;
     }
 
@@ -310,82 +1488,316 @@ static size_t processCommand(struct CanProxy *proxy, const char *request,
       break;
     }
 
+    case 'E':
+    {
+      /* Custom command: select text or binary frame format */
+      if (length == 2 && setFrameFormat(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
     case 'F':
     {
-      /* Read status flags */
-      strcpy(response, "z00\r");
+      /* Read and clear status flags */
+      const uint8_t flags = readStatusFlags(proxy);
+
+      response[0] = 'F';
+      response[1] = binToHex(flags >> 4);
+      response[2] = binToHex(flags & 0x0F);
+      response[3] = '\r';
+      return 4;
+    }
+
+    case 'e':
+    {
+      /* Custom command: read event and driver counters */
+      if (length == 1)
+      {
+        sendCounters(proxy);
+        return 0;
+      }
+
+      strcpy(response, "\a");
       break;
     }
 
     case 'W':
     {
-      /* Filter mode settings */
-      strcpy(response, "\r");
+      /* Enable or disable acceptance filtering */
+      if (length == 2 && setFilterMode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
       break;
     }
 
-    case 'Z':
+    case 'm':
+    case 'M':
     {
-      /* Enable or disable timestamping */
+      /* Set acceptance mask or acceptance code */
+      if (length == 9 && setFilterCode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
       break;
     }
 
-    case 'N':
+    case 'u':
     {
       if (length == 1)
       {
-        /* Read the serial number */
-        const uint16_t number = getSerialNumber(proxy);
-        return packNumber16(response, 'N', number);
+        /* Custom command: read the number of suppressed frames */
+        const uint32_t suppressed = proxy->changes.suppressed;
+
+        response[0] = 'u';
+        inPlaceBinToHex8(response + 1, suppressed);
+        response[9] = '\r';
+        return 10;
       }
-      else if (length == 5)
+
+      /* Custom command: configure on-change forwarding */
+      if ((length == 2 || length == 5)
+          && setChangeMode(proxy, request, length))
       {
-        /* Custom command: set the serial number */
-        if (setSerialNumber(proxy, request))
-          strcpy(response, "\r");
-        else
-          strcpy(response, "\a");
+        strcpy(response, "\r");
       }
       else
         strcpy(response, "\a");
       break;
     }
 
-    case 'V':
+    case 'U':
     {
-      /* Read hardware version */
-      const struct BoardVersion * const ver = getBoardVersion();
-      return packNumber16(response, 'V', (ver->hw.major << 8) | ver->hw.minor);
-    }
+      if (length == 1 && proxy->load.meter != NULL)
+      {
+        /* Custom command: read bus load over 100 ms, 1 s and 10 s */
+        return packBusLoad(proxy, response);
+      }
 
-    case 'A':
-    {
-      /* Custom command: enable or disable automatic retransmission */
-      if (length == 2 && setRetransmissionMode(proxy, request))
+      /* Custom command: configure bus load meter and periodic reports */
+      if ((length == 2 || length == 3)
+          && setBusLoadMode(proxy, request, length))
+      {
         strcpy(response, "\r");
+      }
       else
         strcpy(response, "\a");
       break;
     }
 
-    case 'b':
+    case 'G':
     {
-      /* Custom command: enable or disable blocking mode */
-      if (length == 2 && setBlockingMode(proxy, request))
-        strcpy(response, "\r");
-      else
+      if (length == 1 && proxy->stats.table != NULL)
+      {
+        /* Custom command: read the number of tracked identifiers */
+        const struct TrafficStats * const stats = proxy->stats.table;
+
+        response[0] = 'G';
+        inPlaceBinToHex4(response + 1, (uint16_t)stats->count);
+        inPlaceBinToHex8(response + 5, stats->overflows);
+        response[13] = '\r';
+        return 14;
+      }
+
+      /* Custom command: enable or disable per-identifier statistics */
+      if (length == 2 && setStatisticsMode(proxy, request))
+        strcpy(response, "\r");
+      else
         strcpy(response, "\a");
       break;
     }
 
-    case 'B':
+    case 'H':
+    {
+      if (length == 1 && proxy->stats.hitters != NULL)
+      {
+        /* Custom command: read the number of processed frames */
+        response[0] = 'H';
+        inPlaceBinToHex8(response + 1, proxy->stats.hitters->total);
+        response[9] = '\r';
+        return 10;
+      }
+      else if (length == 2)
+      {
+        /* Custom command: enable or disable heavy-hitter tracking */
+        if (setHitterMode(proxy, request))
+          strcpy(response, "\r");
+        else
+          strcpy(response, "\a");
+      }
+      else if (length == 3 && sendHitterPage(proxy, request))
+      {
+        /* Custom command: read a page of the most frequent identifiers */
+        return 0;
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+#ifdef ENABLE_LATENCY
+    case 'h':
+    {
+      /* Custom command: read and reset the latency histogram */
+      if (length == 1 && sendLatencyHistogram(proxy))
+        return 0;
+
+      strcpy(response, "\a");
+      break;
+    }
+#endif
+
+    case 'n':
+    {
+      /* Custom command: read sequence number of the next forwarded frame */
+      if (length == 1)
+        return packNumber16(response, 'n', proxy->sequence.next);
+
+      /* Custom command: enable or disable frame sequence numbers */
+      if (length == 2 && setSequenceMode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'o':
+    {
+      if (length == 1)
+      {
+        /* Custom command: read dropped frame counters of both classes */
+        response[0] = 'o';
+        inPlaceBinToHex8(response + 1, proxy->overload.dropped[0]);
+        inPlaceBinToHex8(response + 9, proxy->overload.dropped[1]);
+        response[17] = '\r';
+        return 18;
+      }
+
+      /* Custom command: configure overload policy and must-deliver rules */
+      if (setOverloadMode(proxy, request, length))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'q':
+    {
+      if (length == 1)
+      {
+        /* Custom command: read batching deadline and current byte budget */
+        response[0] = 'q';
+        inPlaceBinToHex4(response + 1, proxy->batch.period);
+        inPlaceBinToHex4(response + 5, proxy->batch.policy.budget);
+        response[9] = '\r';
+        return 10;
+      }
+
+      /* Custom command: configure receive batching */
+      if ((length == 2 || length == 5)
+          && setBatchingMode(proxy, request, length))
+      {
+        strcpy(response, "\r");
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'w':
+    {
+      /* Custom command: read and reset work queue handler profile */
+      if (length == 1 && sendWorkProfile(proxy))
+        return 0;
+
+      /* Custom command: enable or disable handler profiling */
+      if (length == 2 && setProfilingMode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'g':
     {
-      /* Custom command: reset to bootloader */
-      resetToBootloader();
+      /* Custom command: read a page of per-identifier statistics */
+      if (length == 3 && sendStatisticsPage(proxy, request))
+        return 0;
+
       strcpy(response, "\a");
       break;
     }
 
+    case 'f':
+    {
+      /* Custom command: add filter rule or remove all rules */
+      if (addFilterRule(proxy, request, length))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'Z':
+    {
+      /* Enable or disable timestamping */
+      if (length == 2 && setTimestampFormat(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'N':
+    {
+      if (length == 1)
+      {
+        /* Read the serial number */
+        const uint16_t number = getSerialNumber(proxy);
+        return packNumber16(response, 'N', number);
+      }
+      else if (length == 5)
+      {
+        /* Custom command: set the serial number */
+        if (setSerialNumber(proxy, request))
+          strcpy(response, "\r");
+        else
+          strcpy(response, "\a");
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'V':
+    {
+      /* Read hardware version */
+      const struct BoardVersion * const ver = getBoardVersion();
+      return packNumber16(response, 'V', (ver->hw.major << 8) | ver->hw.minor);
+    }
+
+    case 'a':
+    {
+      /* Custom command: enable or disable coalesced acknowledgements */
+      if (length == 2 && setAcknowledgementMode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'A':
+    {
+      /* Custom command: enable or disable automatic retransmission */
+      if (length == 2 && setRetransmissionMode(proxy, request))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
     case 'I':
     {
       if (length == 1)
@@ -414,6 +1826,48 @@ static size_t processCommand(struct CanProxy *proxy, const char *request,
       return packNumber16(response, 'v', (ver->sw.major << 8) | ver->sw.minor);
     }
 
+    case 'J':
+    {
+      /* Custom command: add or update periodic frame */
+      if (addCyclicJob(proxy, request, length))
+        strcpy(response, "\r");
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'j':
+    {
+      /* Custom command: remove one or all periodic frames */
+      if ((length == 1 || length == 3)
+          && removeCyclicJobs(proxy, request, length))
+      {
+        strcpy(response, "\r");
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
+    case 'K':
+    {
+      /* Custom command: measure frame encoding and decoding time */
+      uint16_t results[4];
+
+      if (length == 1 && measureCodecSpeed(proxy, results))
+      {
+        response[0] = 'K';
+        for (size_t i = 0; i < ARRAY_SIZE(results); ++i)
+          inPlaceBinToHex4(response + 1 + i * 4, results[i]);
+        response[1 + ARRAY_SIZE(results) * 4] = '\r';
+
+        return 2 + ARRAY_SIZE(results) * 4;
+      }
+      else
+        strcpy(response, "\a");
+      break;
+    }
+
     case 'x':
     {
       /* Custom command: send test sequence */
@@ -434,251 +1888,1299 @@ static size_t processCommand(struct CanProxy *proxy, const char *request,
   return strlen(response);
 }
 /*----------------------------------------------------------------------------*/
-static void readSerialInput(struct CanProxy *proxy)
+static void profileEnqueue(struct CanProxy *proxy, enum WorkHandler handler,
+    bool added)
+{
+  /* Only handlers of the same port are visible to the proxy */
+  const size_t pending = proxy->events.can + proxy->events.jobs
+      + proxy->events.serial;
+
+  /* Callbacks of different interrupt priorities may preempt each other */
+  const IrqState state = irqSave();
+  workProfileEnqueue(proxy->work.profile, handler, pending, added);
+  irqRestore(state);
+}
+/*----------------------------------------------------------------------------*/
+static void profileRun(struct CanProxy *proxy, enum WorkHandler handler,
+    uint32_t started)
+{
+  /* Profiling may be disabled by a command processed in the handler */
+  if (proxy->work.profile != NULL)
+  {
+    workProfileRun(proxy->work.profile, handler,
+        timerGetValue(proxy->chrono) - started);
+  }
+}
+/*----------------------------------------------------------------------------*/
+#ifdef ENABLE_LATENCY
+static void queueLatency(struct CanProxy *proxy, const uint32_t *stamps,
+    size_t count)
+{
+  if (proxy->chrono == NULL)
+    return;
+
+  /* The batch ends after the data pending in the output ring */
+  const uint32_t end = proxy->latency.sent + proxy->output.count;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (proxy->latency.count == LATENCY_QUEUE_SIZE)
+    {
+      /* The oldest sample is closed early when the queue is full */
+      const struct LatencySample * const sample =
+          &proxy->latency.queue[proxy->latency.head];
+
+      latencyHistogramAdd(&proxy->latency.histogram,
+          (timerGetValue(proxy->chrono) - sample->stamp)
+          / proxy->latency.divisor);
+
+      proxy->latency.head = (proxy->latency.head + 1) % LATENCY_QUEUE_SIZE;
+      --proxy->latency.count;
+    }
+
+    const size_t tail =
+        (proxy->latency.head + proxy->latency.count) % LATENCY_QUEUE_SIZE;
+
+    proxy->latency.queue[tail] = (struct LatencySample){stamps[i], end};
+    ++proxy->latency.count;
+  }
+
+  /* Samples of the data written directly are closed at once */
+  updateLatency(proxy);
+}
+#endif
+/*----------------------------------------------------------------------------*/
+static void readSerialInput(struct CanProxy *proxy)
+{
+  size_t count;
+
+  do
+  {
+    char buffer[SERIAL_MTU];
+    size_t available;
+    uint8_t ready;
+
+    ifGetParam(proxy->can, IF_TX_AVAILABLE, &available);
+    ready = available >= SERIALIZED_QUEUE_SIZE;
+    ifSetParam(proxy->serial, IF_SERIAL_RTS, &ready);
+
+    if (proxy->blocking && available < SERIALIZED_QUEUE_SIZE)
+      break;
+
+    count = ifRead(proxy->serial, buffer, sizeof(buffer));
+
+    for (size_t index = 0; index < count;)
+    {
+      if (proxy->format == SLCAN_FORMAT_BINARY)
+        index += parseBinaryInput(proxy, buffer + index, count - index);
+      else
+        index += parseTextInput(proxy, buffer + index, count - index);
+    }
+  }
+  while (count > 0);
+
+  /* Frames of the whole input batch are acknowledged with one record */
+  flushAcknowledgements(proxy);
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t readStatusFlags(struct CanProxy *proxy)
+{
+  const uint32_t overruns = getDriverCounter(proxy, IF_CAN_OVERRUNS);
+  const uint32_t errors = getDriverCounter(proxy, IF_CAN_RX_ERRORS)
+      + getDriverCounter(proxy, IF_CAN_TX_ERRORS);
+  uint8_t flags = proxy->status.flags;
+
+  /* Driver errors are detected by changes of the driver counters */
+  if (overruns != proxy->status.overruns)
+    flags |= STATUS_OVERRUN;
+  if (errors != proxy->status.errors)
+    flags |= STATUS_BUS_ERROR;
+
+  proxy->status.overruns = overruns;
+  proxy->status.errors = errors;
+  proxy->status.flags = 0;
+
+  return flags;
+}
+/*----------------------------------------------------------------------------*/
+static bool removeCyclicJobs(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  if (proxy->jobs.wheel == NULL)
+    return length == 1;
+
+  if (length == 1)
+  {
+    jobWheelClear(proxy->jobs.wheel);
+  }
+  else
+  {
+    const size_t index = (hexToBin(request[1]) << 4) | hexToBin(request[2]);
+
+    if (!jobWheelRemove(proxy->jobs.wheel, index))
+      return false;
+  }
+
+  updateJobTimer(proxy);
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void sendCounters(struct CanProxy *proxy)
+{
+  const uint32_t counters[] = {
+      proxy->status.received,
+      proxy->status.transmitted,
+      proxy->status.canOverruns,
+      proxy->status.serialOverruns,
+      proxy->status.serialErrors,
+      getDriverCounter(proxy, IF_CAN_OVERRUNS),
+      getDriverCounter(proxy, IF_CAN_RX_ERRORS),
+      getDriverCounter(proxy, IF_CAN_TX_ERRORS)
+  };
+  char response[1 + ARRAY_SIZE(counters) * 8 + 1];
+
+  response[0] = 'e';
+  for (size_t i = 0; i < ARRAY_SIZE(counters); ++i)
+    inPlaceBinToHex8(response + 1 + i * 8, counters[i]);
+  response[sizeof(response) - 1] = '\r';
+
+  writeResponse(proxy, response, sizeof(response));
+}
+/*----------------------------------------------------------------------------*/
+static void sendCyclicFrame(void *argument, const struct ProxyMessage *message)
+{
+  struct CanProxy * const proxy = argument;
+
+  /* Periodic frames are sent only when the channel is open */
+  if (proxy->mode != SLCAN_MODE_ACTIVE && proxy->mode != SLCAN_MODE_LOOPBACK)
+    return;
+
+  if (ifWrite(proxy->can, message, sizeof(*message)) == sizeof(*message))
+  {
+    if (proxy->load.meter != NULL)
+      updateBusLoad(proxy, message, 1);
+
+    notifyEvent(proxy, SLCAN_EVENT_TX);
+  }
+  else
+    notifyEvent(proxy, SLCAN_EVENT_CAN_OVERRUN);
+}
+/*----------------------------------------------------------------------------*/
+static void sendDropMarker(struct CanProxy *proxy)
+{
+  /* Type (1) + Two counters (8 * 2) + EOL (1) */
+  char response[RESPONSE_MTU];
+  size_t length;
+
+  if (proxy->format == SLCAN_FORMAT_BINARY)
+  {
+    /* Binary records can not be mixed with text records */
+    length = packBinaryDrops(response, proxy->overload.unreported[0],
+        proxy->overload.unreported[1]);
+  }
+  else
+  {
+    response[0] = 'o';
+    inPlaceBinToHex8(response + 1, proxy->overload.unreported[0]);
+    inPlaceBinToHex8(response + 9, proxy->overload.unreported[1]);
+    response[17] = '\r';
+    length = 18;
+  }
+
+  /* Counters are kept until the marker is queued */
+  if (!writeOutput(proxy, response, length))
+    return;
+
+  proxy->overload.unreported[0] = 0;
+  proxy->overload.unreported[1] = 0;
+}
+/*----------------------------------------------------------------------------*/
+static bool sendHitterPage(struct CanProxy *proxy, const char *request)
+{
+  if (proxy->stats.hitters == NULL)
+    return false;
+
+  struct HitterEstimate estimates[HEAVY_HITTERS_PAGE];
+  char buffer[HEAVY_HITTERS_RECORD * HEAVY_HITTERS_PAGE + 1];
+  const size_t page = (hexToBin(request[1]) << 4) | hexToBin(request[2]);
+  const size_t count = heavyHittersGetTop(proxy->stats.hitters, estimates,
+      page * HEAVY_HITTERS_PAGE, HEAVY_HITTERS_PAGE);
+  size_t length = 0;
+  size_t available;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    char * const record = buffer + length;
+
+    record[0] = 'H';
+    inPlaceBinToHex8(record + 1, estimates[i].id);
+    inPlaceBinToHex8(record + 9, estimates[i].count);
+    inPlaceBinToHex8(record + 17, estimates[i].error);
+    record[25] = '\r';
+
+    length += HEAVY_HITTERS_RECORD;
+  }
+
+  /* Empty line marks the end of the page */
+  buffer[length++] = '\r';
+
+  /* Page is written only as a whole, the host retries on failure */
+  ifGetParam(proxy->serial, IF_TX_AVAILABLE, &available);
+  if (available < length)
+    return false;
+
+  writeResponse(proxy, buffer, length);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+#ifdef ENABLE_LATENCY
+static bool sendLatencyHistogram(struct CanProxy *proxy)
+{
+  const struct LatencyHistogram * const histogram = &proxy->latency.histogram;
+  char buffer[LATENCY_HISTOGRAM_RECORD];
+  size_t available;
+
+  ifGetParam(proxy->serial, IF_TX_AVAILABLE, &available);
+  if (available < sizeof(buffer))
+    return false;
+
+  buffer[0] = 'h';
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BINS; ++i)
+    inPlaceBinToHex8(buffer + 1 + i * 8, histogram->bins[i]);
+  inPlaceBinToHex8(buffer + 1 + LATENCY_HISTOGRAM_BINS * 8, histogram->max);
+  buffer[sizeof(buffer) - 1] = '\r';
+
+  writeResponse(proxy, buffer, sizeof(buffer));
+  latencyHistogramReset(&proxy->latency.histogram);
+  return true;
+}
+#endif
+/*----------------------------------------------------------------------------*/
+static bool sendMessageGroup(struct CanProxy *proxy, uint8_t flags,
+    size_t length, size_t count)
+{
+  struct ProxyMessage message = {
+      .timestamp = 0,
+      .id = 0,
+      .flags = flags,
+      .length = length
+  };
+  uint32_t rate;
+
+  if (proxy->chrono == NULL)
+    return false;
+  if (ifGetParam(proxy->can, IF_RATE, &rate) != E_OK || rate == 0)
+    return false;
+
+  uint32_t frameTime = calcFrameLength(flags, length) * 1000000 / rate;
+
+#ifdef CONFIG_CAN_FD
+  const uint32_t dataPhaseLength = calcDataPhaseLength(flags, length);
+
+  if (dataPhaseLength)
+  {
+    /* Data phase of frames with bit rate switching uses a separate rate */
+    if (ifGetParam(proxy->can, IF_CAN_FD_RATE, &rate) != E_OK || rate == 0)
+      return false;
+
+    frameTime += dataPhaseLength * 1000000 / rate;
+  }
+#endif
+
+  const uint32_t groupTimeout = frameTime * count;
+  const uint32_t timestamp = timerGetValue(proxy->chrono);
+
+  for (size_t i = 0; i < ARRAY_SIZE(message.data); ++i)
+    message.data[i] = (uint8_t)(i + 1);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    message.id = (uint32_t)i;
+
+    while (ifWrite(proxy->can, &message, sizeof(message)) != sizeof(message))
+    {
+      if (timerGetValue(proxy->chrono) - timestamp > groupTimeout)
+        return false;
+    }
+
+    if (proxy->load.meter != NULL)
+      updateBusLoad(proxy, &message, 1);
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool sendStatisticsPage(struct CanProxy *proxy, const char *request)
+{
+  const struct TrafficStats * const stats = proxy->stats.table;
+
+  if (stats == NULL)
+    return false;
+
+  char buffer[TRAFFIC_STATS_RECORD * TRAFFIC_STATS_PAGE + 1];
+  const uint32_t divisor = proxy->stats.divisor;
+  size_t skip = ((hexToBin(request[1]) << 4) | hexToBin(request[2]))
+      * TRAFFIC_STATS_PAGE;
+  size_t length = 0;
+  size_t available;
+
+  for (size_t i = 0; i < ARRAY_SIZE(stats->entries)
+      && length < TRAFFIC_STATS_RECORD * TRAFFIC_STATS_PAGE; ++i)
+  {
+    const struct TrafficEntry * const entry = stats->entries + i;
+
+    if (entry->id == TRAFFIC_STATS_NONE)
+      continue;
+
+    if (skip)
+    {
+      --skip;
+      continue;
+    }
+
+    char * const record = buffer + length;
+
+    record[0] = 'g';
+    inPlaceBinToHex8(record + 1, entry->id);
+    record[9] = binToHex(entry->dlc);
+    inPlaceBinToHex8(record + 10, entry->count);
+    inPlaceBinToHex8(record + 18, entry->last / divisor);
+    inPlaceBinToHex8(record + 26, entry->minGap / divisor);
+    inPlaceBinToHex8(record + 34, entry->maxGap / divisor);
+    record[42] = '\r';
+
+    length += TRAFFIC_STATS_RECORD;
+  }
+
+  /* Empty line marks the end of the page */
+  buffer[length++] = '\r';
+
+  /* Page is written only as a whole, the host retries on failure */
+  ifGetParam(proxy->serial, IF_TX_AVAILABLE, &available);
+  if (available < length)
+    return false;
+
+  writeResponse(proxy, buffer, length);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool sendTestMessages(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  static const size_t testGroupSize = 1000;
+
+  if (length == 1)
+  {
+    bool completed = true;
+
+    for (size_t i = 0; completed && (i < ARRAY_SIZE(testGroupSettings)); ++i)
+    {
+      completed = sendMessageGroup(proxy, testGroupSettings[i].flags,
+          testGroupSettings[i].length, testGroupSize);
+    }
+
+    return completed;
+  }
+  else if (length == 2)
+  {
+    const unsigned int code = hexToBin(request[1]);
+
+    if (code < ARRAY_SIZE(testGroupSettings))
+    {
+      return sendMessageGroup(proxy, testGroupSettings[code].flags,
+          testGroupSettings[code].length, testGroupSize);
+    }
+    else
+      return false;
+  }
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool sendWorkProfile(struct CanProxy *proxy)
+{
+  if (proxy->work.profile == NULL)
+    return false;
+
+  char buffer[WORK_PROFILE_RECORD * WORK_HANDLER_END + WORK_PROFILE_TOTAL];
+  size_t available;
+
+  ifGetParam(proxy->serial, IF_TX_AVAILABLE, &available);
+  if (available < sizeof(buffer))
+    return false;
+
+  const uint32_t divisor = proxy->work.divisor;
+  const uint32_t now = timerGetValue(proxy->chrono);
+  struct WorkProfile profile;
+  uint64_t busy = 0;
+  size_t length = 0;
+
+  /* Enqueue counters are updated by interrupt callbacks */
+  const IrqState state = irqSave();
+  profile = *proxy->work.profile;
+  workProfileReset(proxy->work.profile, now);
+  irqRestore(state);
+
+  const uint32_t elapsed = now - profile.start;
+
+  for (size_t i = 0; i < ARRAY_SIZE(profile.handlers); ++i)
+  {
+    const struct HandlerProfile * const entry = profile.handlers + i;
+    const uint32_t count = entry->count;
+    char * const record = buffer + length;
+
+    record[0] = 'w';
+    record[1] = binToHex((uint8_t)i);
+    inPlaceBinToHex8(record + 2, count);
+    inPlaceBinToHex8(record + 10, count ? entry->min / divisor : 0);
+    inPlaceBinToHex8(record + 18,
+        count ? (uint32_t)(entry->total / count / divisor) : 0);
+    inPlaceBinToHex8(record + 26, entry->max / divisor);
+    /* Average number of pending handlers in 0.01 units */
+    inPlaceBinToHex4(record + 34, entry->enqueued ?
+        (uint16_t)MIN((uint64_t)entry->pending * 100 / entry->enqueued,
+            UINT16_MAX) : 0);
+    inPlaceBinToHex8(record + 38, entry->dropped);
+    record[46] = '\r';
+
+    busy += entry->total;
+    length += WORK_PROFILE_RECORD;
+  }
+
+  /* Busy time of all handlers in 0.01 % units */
+  buffer[length] = 'w';
+  inPlaceBinToHex4(buffer + length + 1,
+      elapsed ? (uint16_t)MIN(busy * 10000 / elapsed, 10000) : 0);
+  buffer[length + 5] = '\r';
+
+  writeResponse(proxy, buffer, sizeof(buffer));
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static size_t serializeFrames(struct CanProxy *proxy, char *buffer,
+    const struct ProxyMessage *frames, const uint16_t *sequences,
+    size_t count)
+{
+  size_t length = 0;
+
+  if (proxy->sequence.enabled)
+  {
+    const bool binary = proxy->format == SLCAN_FORMAT_BINARY;
+
+    /* Frames are packed one by one to append sequence numbers */
+    for (size_t i = 0; i < count; ++i)
+    {
+      size_t record;
+
+      if (binary)
+      {
+        record = packBinaryFrame(buffer + length, frames + i,
+            proxy->timestamp.format != TIMESTAMP_NONE);
+      }
+      else if (proxy->format == SLCAN_FORMAT_DELTA)
+      {
+        record = packDeltaFrames(proxy->dictionary, buffer + length,
+            frames + i, 1, proxy->timestamp.format);
+      }
+      else
+      {
+        record = packFrame(buffer + length, frames + i,
+            proxy->timestamp.format);
+      }
+
+      length += packSequence(buffer + length, record, sequences[i], binary);
+    }
+  }
+  else if (proxy->format == SLCAN_FORMAT_BINARY)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      length += packBinaryFrame(buffer + length, frames + i,
+          proxy->timestamp.format != TIMESTAMP_NONE);
+    }
+  }
+  else if (proxy->format == SLCAN_FORMAT_DELTA)
+  {
+    length = packDeltaFrames(proxy->dictionary, buffer, frames, count,
+        proxy->timestamp.format);
+  }
+  else
+    length = packFrames(buffer, frames, count, proxy->timestamp.format);
+
+  return length;
+}
+/*----------------------------------------------------------------------------*/
+static bool setAcknowledgementMode(struct CanProxy *proxy,
+    const char *request)
+{
+  if (request[1] == '0')
+  {
+    /* Report frames accepted before the mode change */
+    flushAcknowledgements(proxy);
+    proxy->acks.coalesced = false;
+    return true;
+  }
+  else if (request[1] == '1')
+  {
+    proxy->acks.coalesced = true;
+    return true;
+  }
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool setBatchingMode(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  if (length == 2)
+  {
+    if (request[1] != '0')
+      return false;
+
+    /* Waiting frames are sent by the next serial or CAN event */
+    batchPolicyDisable(&proxy->batch.policy);
+    proxy->batch.period = 0;
+
+    if (proxy->jobs.timer != NULL)
+      updateJobTimer(proxy);
+    return true;
+  }
+
+  if (proxy->chrono == NULL || proxy->jobs.timer == NULL)
+    return false;
+
+  const uint16_t period = (uint16_t)((hexToBin(request[1]) << 12)
+      | (hexToBin(request[2]) << 8) | (hexToBin(request[3]) << 4)
+      | hexToBin(request[4]));
+  const uint32_t divisor = timerGetFrequency(proxy->chrono) / 1000000;
+
+  if (!period || !divisor)
+    return false;
+
+  batchPolicyEnable(&proxy->batch.policy, period * divisor,
+      getFrameMtu(proxy), timerGetValue(proxy->chrono));
+  proxy->batch.divisor = divisor;
+  proxy->batch.period = period;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool setBlockingMode(struct CanProxy *proxy, const char *request)
+{
+  if (request[1] == '0')
+  {
+    proxy->blocking = false;
+    return true;
+  }
+  else if (request[1] == '1')
+  {
+    proxy->blocking = true;
+    return true;
+  }
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool setBusLoadMode(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  if (length == 3)
+  {
+    const uint8_t interval = (hexToBin(request[1]) << 4) | hexToBin(request[2]);
+
+    if (proxy->load.meter == NULL || (interval && proxy->jobs.timer == NULL))
+      return false;
+
+    proxy->load.elapsed = 0;
+    proxy->load.interval = interval;
+
+    if (proxy->jobs.timer != NULL)
+      updateJobTimer(proxy);
+
+    return true;
+  }
+
+  switch (request[1])
+  {
+    case '0':
+      free(proxy->load.meter);
+      proxy->load.meter = NULL;
+      proxy->load.interval = 0;
+
+      if (proxy->jobs.timer != NULL)
+        updateJobTimer(proxy);
+      return true;
+
+    case '1':
+    {
+      if (proxy->chrono == NULL)
+        return false;
+
+      /* Each bucket of the meter covers 100 ms */
+      const uint32_t period = timerGetFrequency(proxy->chrono) / 10;
+
+      if (!period)
+        return false;
+
+      if (proxy->load.meter == NULL)
+      {
+        proxy->load.meter = malloc(sizeof(struct BusLoad));
+        if (proxy->load.meter == NULL)
+          return false;
+      }
+
+      busLoadInit(proxy->load.meter, timerGetValue(proxy->chrono), period);
+      proxy->load.elapsed = 0;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool setChangeMode(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  uint16_t period = 0;
+
+  if (length == 2)
+  {
+    if (request[1] == '0')
+    {
+      free(proxy->changes.cache);
+      proxy->changes.cache = NULL;
+      return true;
+    }
+    else if (request[1] != '1')
+      return false;
+  }
+  else
+  {
+    /* Refresh period requires timestamps of received frames */
+    period = inPlaceHexToBin4(request + 1);
+
+    if (period && proxy->chrono == NULL)
+      return false;
+  }
+
+  if (proxy->changes.cache == NULL)
+  {
+    proxy->changes.cache = malloc(sizeof(struct ChangeCache));
+    if (proxy->changes.cache == NULL)
+      return false;
+  }
+
+  if (proxy->chrono != NULL)
+    proxy->changes.divisor = MAX(timerGetFrequency(proxy->chrono) / 1000, 1);
+  proxy->changes.suppressed = 0;
+  proxy->changes.period = period;
+  changeCacheReset(proxy->changes.cache);
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool setCustomDataRate(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  uint32_t rate = 0;
+
+  for (size_t i = 1; i < length; ++i)
+    rate = (rate << 4) | hexToBin(request[i]);
+
+  return setDataRate(proxy, rate);
+}
+/*----------------------------------------------------------------------------*/
+static bool setCustomRate(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  uint32_t rate = 0;
+
+  for (size_t i = 1; i < length; ++i)
+    rate = (rate << 4) | hexToBin(request[i]);
+
+  return ifSetParam(proxy->can, IF_RATE, &rate) == E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static bool setDataRate([[maybe_unused]] struct CanProxy *proxy,
+    [[maybe_unused]] uint32_t rate)
+{
+#ifdef CONFIG_CAN_FD
+  return ifSetParam(proxy->can, IF_CAN_FD_RATE, &rate) == E_OK;
+#else
+  /* Flexible data rate is not supported by the controller */
+  return false;
+#endif
+}
+/*----------------------------------------------------------------------------*/
+static bool setFilterCode(struct CanProxy *proxy, const char *request)
+{
+  struct IdFilter * const filter = getIdFilter(proxy);
+
+  if (filter == NULL)
+    return false;
+
+  const uint32_t value = ((uint32_t)inPlaceHexToBin4(request + 1) << 16)
+      | inPlaceHexToBin4(request + 5);
+
+  /* Mask bits set to one are ignored during comparison */
+  if (request[0] == 'M')
+    idFilterSetCode(filter, value);
+  else
+    idFilterSetMask(filter, value);
+
+  updateFilterBank(proxy);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool setFilterMode(struct CanProxy *proxy, const char *request)
+{
+  switch (request[1])
+  {
+    case '0':
+      proxy->filter.enabled = false;
+      break;
+
+    case '1':
+      if (getIdFilter(proxy) == NULL)
+        return false;
+
+      proxy->filter.enabled = true;
+      break;
+
+    default:
+      return false;
+  }
+
+  updateFilterBank(proxy);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool setFrameFormat(struct CanProxy *proxy, const char *request)
+{
+  enum CanProxyFormat format;
+
+  switch (request[1])
+  {
+    case '0':
+      format = SLCAN_FORMAT_TEXT;
+      break;
+
+    case '1':
+      format = SLCAN_FORMAT_BINARY;
+      break;
+
+    case '2':
+      format = SLCAN_FORMAT_DELTA;
+      break;
+
+    default:
+      return false;
+  }
+
+  if (format == SLCAN_FORMAT_DELTA)
+  {
+    if (proxy->dictionary == NULL)
+    {
+      proxy->dictionary = malloc(sizeof(struct DeltaDictionary));
+      if (proxy->dictionary == NULL)
+        return false;
+    }
+
+    /* Host starts with an empty dictionary after each mode request */
+    resetDeltaDictionary(proxy->dictionary);
+  }
+  else
+  {
+    free(proxy->dictionary);
+    proxy->dictionary = NULL;
+  }
+
+  proxy->format = format;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool setHitterMode(struct CanProxy *proxy, const char *request)
+{
+  switch (request[1])
+  {
+    case '0':
+      free(proxy->stats.hitters);
+      proxy->stats.hitters = NULL;
+      return true;
+
+    case '1':
+      if (proxy->stats.hitters == NULL)
+      {
+        proxy->stats.hitters = malloc(sizeof(struct HeavyHitters));
+        if (proxy->stats.hitters == NULL)
+          return false;
+      }
+
+      heavyHittersReset(proxy->stats.hitters);
+      return true;
+
+    default:
+      return false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool setInitialRate(struct CanProxy *proxy, const char *request)
+{
+  if (proxy->settings != NULL)
+  {
+    struct Settings * const settings = proxy->settings->data;
+    const uint8_t value = hexToBin(request[1]);
+
+    if (slcanRatePresetToValue(value))
+      settings->initial[proxy->number] = value;
+    else
+      settings->initial[proxy->number] = -1;
+    settingsSave(proxy->settings, NULL, NULL);
+
+    return true;
+  }
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool setOverloadMode(struct CanProxy *proxy, const char *request,
+    size_t length)
+{
+  if (length > 2)
+  {
+    if (proxy->overload.rules == NULL)
+    {
+      proxy->overload.rules = malloc(sizeof(struct IdFilter));
+      if (proxy->overload.rules == NULL)
+        return false;
+
+      idFilterClear(proxy->overload.rules);
+    }
+
+    return addIdRule(proxy->overload.rules, request, length);
+  }
+
+  switch (request[1])
+  {
+    case '0':
+      proxy->overload.enabled = false;
+      return true;
+
+    case '1':
+      proxy->overload.enabled = true;
+      return true;
+
+    case '2':
+      free(proxy->overload.rules);
+      proxy->overload.rules = NULL;
+      return true;
+
+    default:
+      return false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool setPredefinedDataRate(struct CanProxy *proxy,
+    const char *request)
 {
-  size_t count;
+  static const uint32_t DATA_RATE_MAP[] = {
+      1000000,
+      2000000,
+      4000000,
+      5000000,
+      8000000
+  };
 
-  do
-  {
-    char buffer[SERIAL_MTU];
-    size_t available;
-    uint8_t ready;
+  const unsigned int code = hexToBin(request[1]);
 
-    ifGetParam(proxy->can, IF_TX_AVAILABLE, &available);
-    ready = available >= SERIALIZED_QUEUE_SIZE;
-    ifSetParam(proxy->serial, IF_SERIAL_RTS, &ready);
+  if (code < ARRAY_SIZE(DATA_RATE_MAP))
+    return setDataRate(proxy, DATA_RATE_MAP[code]);
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool setPredefinedRate(struct CanProxy *proxy, const char *request)
+{
+  const unsigned int code = hexToBin(request[1]);
+  const uint32_t rate = slcanRatePresetToValue(code);
 
-    if (proxy->blocking && available < SERIALIZED_QUEUE_SIZE)
-      break;
+  if (rate)
+    return ifSetParam(proxy->can, IF_RATE, &rate) == E_OK;
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool setProfilingMode(struct CanProxy *proxy, const char *request)
+{
+  switch (request[1])
+  {
+    case '0':
+    {
+      struct WorkProfile * const profile = proxy->work.profile;
 
-    count = ifRead(proxy->serial, buffer, sizeof(buffer));
+      /* Pointer is cleared first, it is also used by interrupt callbacks */
+      proxy->work.profile = NULL;
+      free(profile);
+      return true;
+    }
 
-    for (size_t index = 0; index < count; ++index)
+    case '1':
     {
-      const char c = buffer[index];
+      if (proxy->chrono == NULL)
+        return false;
 
-      if (c == '\r' || c == '\n') /* New line */
-      {
-        if (!proxy->parser.skip)
-        {
-          proxy->parser.arena[proxy->parser.position] = '\0';
-
-          char response[RESPONSE_MTU];
-          const size_t responseLength = processCommand(proxy,
-              proxy->parser.arena, proxy->parser.position, response);
-          const size_t writtenLength = ifWrite(proxy->serial,
-              response, responseLength);
-
-          if (writtenLength != responseLength)
-          {
-            proxy->callback(proxy->argument, proxy->mode,
-                SLCAN_EVENT_SERIAL_OVERRUN);
-          }
-        }
+      struct WorkProfile *profile = proxy->work.profile;
 
-        proxy->parser.position = 0;
-        proxy->parser.skip = false;
-      }
-      else if (proxy->parser.position < sizeof(proxy->parser.arena) - 1)
+      if (profile == NULL)
       {
-        proxy->parser.arena[proxy->parser.position++] = c;
-      }
-      else
-      {
-        proxy->parser.skip = true;
+        profile = malloc(sizeof(struct WorkProfile));
+        if (profile == NULL)
+          return false;
       }
+
+      proxy->work.divisor =
+          MAX(timerGetFrequency(proxy->chrono) / 1000000, 1);
+
+      const IrqState state = irqSave();
+      workProfileReset(profile, timerGetValue(proxy->chrono));
+      proxy->work.profile = profile;
+      irqRestore(state);
+      return true;
     }
+
+    default:
+      return false;
   }
-  while (count > 0);
 }
 /*----------------------------------------------------------------------------*/
-static bool sendMessageGroup(struct CanProxy *proxy, uint8_t flags,
-    size_t length, size_t count)
+static bool setRetransmissionMode(struct CanProxy *proxy, const char *request)
 {
-  uint32_t rate;
-
-  if (proxy->chrono == NULL)
+  if (request[1] == '0')
+  {
+    return ifSetParam(proxy->can, IF_CAN_RETRANSMISSION, &(uint8_t){0}) == E_OK;
+  }
+  else if (request[1] == '1')
+  {
+    return ifSetParam(proxy->can, IF_CAN_RETRANSMISSION, &(uint8_t){1}) == E_OK;
+  }
+  else
     return false;
-  if (ifGetParam(proxy->can, IF_RATE, &rate) != E_OK || rate == 0)
+}
+/*----------------------------------------------------------------------------*/
+static bool setSequenceMode(struct CanProxy *proxy, const char *request)
+{
+  if (request[1] == '0')
+  {
+    proxy->sequence.enabled = false;
+    return true;
+  }
+  else if (request[1] == '1')
+  {
+    /* Numbering starts over each time the mode is enabled */
+    proxy->sequence.next = 0;
+    proxy->sequence.enabled = true;
+    return true;
+  }
+  else
     return false;
-
-  const uint32_t frameLength = calcFrameLength(flags, length);
-  const uint32_t groupTimeout = (frameLength * 1000000 / rate) * count;
-  const uint32_t timestamp = timerGetValue(proxy->chrono);
-
-  for (size_t i = 0; i < count; ++i)
+}
+/*----------------------------------------------------------------------------*/
+static bool setSerialNumber(struct CanProxy *proxy, const char *request)
+{
+  if (proxy->settings != NULL)
   {
-    const struct CANStandardMessage message = {
-        .timestamp = 0,
-        .id = (uint32_t)i,
-        .flags = flags,
-        .length = length,
-        .data = {1, 2, 3, 4, 5, 6, 7, 8}
-    };
+    struct Settings * const settings = proxy->settings->data;
 
-    while (ifWrite(proxy->can, &message, sizeof(message)) != sizeof(message))
+    if (!isSerialNumberValid(settings->serial))
     {
-      if (timerGetValue(proxy->chrono) - timestamp > groupTimeout)
-        return false;
+      settings->serial = inPlaceHexToBin4(&request[1]);
+      settingsSave(proxy->settings, NULL, NULL);
+      return true;
     }
   }
 
-  return true;
+  return false;
 }
 /*----------------------------------------------------------------------------*/
-static bool sendTestMessages(struct CanProxy *proxy, const char *request,
-    size_t length)
+static bool setStatisticsMode(struct CanProxy *proxy, const char *request)
 {
-  struct GroupSettings
+  switch (request[1])
   {
-    uint8_t flags;
-    uint8_t length;
-  };
+    case '0':
+      free(proxy->stats.table);
+      proxy->stats.table = NULL;
+      return true;
 
-  static const size_t testGroupSize = 1000;
-  static const struct GroupSettings testGroupSettings[] = {
-      /* Standard frames with empty data field */
-      {0, 0},
-      /* Standard frames with 64-bit data field */
-      {0, 8},
-      /* Extended frames with empty data field */
-      {CAN_EXT_ID, 0},
-      /* Extended frames with 64-bit data field */
-      {CAN_EXT_ID, 8},
-      /* Standard RTR frames */
-      {CAN_RTR, 0},
-      /* Extended RTR frames */
-      {CAN_RTR | CAN_EXT_ID, 0}
-  };
+    case '1':
+      if (proxy->stats.table == NULL)
+      {
+        proxy->stats.table = malloc(sizeof(struct TrafficStats));
+        if (proxy->stats.table == NULL)
+          return false;
+      }
 
-  if (length == 1)
-  {
-    bool completed = true;
+      if (proxy->chrono != NULL)
+      {
+        proxy->stats.divisor =
+            MAX(timerGetFrequency(proxy->chrono) / 1000000, 1);
+      }
 
-    for (size_t i = 0; completed && (i < ARRAY_SIZE(testGroupSettings)); ++i)
-    {
-      completed = sendMessageGroup(proxy, testGroupSettings[i].flags,
-          testGroupSettings[i].length, testGroupSize);
-    }
+      trafficStatsReset(proxy->stats.table);
+      return true;
 
-    return completed;
+    default:
+      return false;
   }
-  else if (length == 2)
+}
+/*----------------------------------------------------------------------------*/
+static bool setTimestampFormat(struct CanProxy *proxy, const char *request)
+{
+  enum TimestampFormat format;
+  uint32_t resolution;
+
+  switch (request[1])
   {
-    const unsigned int code = hexToBin(request[1]);
+    case '0':
+      proxy->timestamp.format = TIMESTAMP_NONE;
+      return true;
 
-    if (code < ARRAY_SIZE(testGroupSettings))
-    {
-      return sendMessageGroup(proxy, testGroupSettings[code].flags,
-          testGroupSettings[code].length, testGroupSize);
-    }
-    else
+    case '1':
+      /* Standard 16-bit timestamps in milliseconds */
+      format = TIMESTAMP_16_BIT;
+      resolution = 1000;
+      break;
+
+    case '2':
+      /* Custom 32-bit timestamps in microseconds */
+      format = TIMESTAMP_32_BIT;
+      resolution = 1000000;
+      break;
+
+    default:
       return false;
   }
+
+  if (proxy->chrono == NULL)
+    return false;
+
+  const uint32_t divisor = timerGetFrequency(proxy->chrono) / resolution;
+
+  if (divisor)
+  {
+    proxy->timestamp.divisor = divisor;
+    proxy->timestamp.format = format;
+    return true;
+  }
   else
     return false;
 }
 /*----------------------------------------------------------------------------*/
-static void serializeFrames(struct CanProxy *proxy,
-    const struct CANStandardMessage *frames, size_t count)
+static size_t shedFrames(struct CanProxy *proxy,
+    struct ProxyMessage *frames, uint16_t *sequences, size_t count,
+    size_t room)
 {
-  char response[SERIALIZED_FRAME_MTU * SERIALIZED_QUEUE_SIZE];
-  size_t length = 0;
+  size_t priorities = 0;
+  size_t quotas[2];
+  size_t kept = 0;
+
+  if (proxy->overload.rules != NULL)
+  {
+    for (size_t i = 0; i < count; ++i)
+      priorities += isMustDeliver(proxy, frames + i);
+  }
+
+  /* Room is filled with must-deliver frames first, then with other frames */
+  quotas[0] = MIN(priorities, room);
+  quotas[1] = room - quotas[0];
 
   for (size_t i = 0; i < count; ++i)
-    length += packFrame(response + length, frames + i);
+  {
+    const size_t index = isMustDeliver(proxy, frames + i) ? 0 : 1;
+
+    if (quotas[index])
+    {
+      --quotas[index];
+
+      if (kept != i)
+      {
+        frames[kept] = frames[i];
+        sequences[kept] = sequences[i];
+      }
+      ++kept;
+    }
+    else
+    {
+      ++proxy->overload.dropped[index];
+      ++proxy->overload.unreported[index];
+    }
+  }
 
-  const size_t written = ifWrite(proxy->serial, response, length);
+  if (kept != count)
+    notifyEvent(proxy, SLCAN_EVENT_SERIAL_OVERRUN);
 
-  proxy->callback(proxy->argument, proxy->mode, written == length ?
-      SLCAN_EVENT_RX : SLCAN_EVENT_SERIAL_OVERRUN);
+  return kept;
 }
 /*----------------------------------------------------------------------------*/
-static bool setBlockingMode(struct CanProxy *proxy, const char *request)
+static size_t suppressFrames(struct CanProxy *proxy,
+    struct ProxyMessage *frames, size_t count)
 {
-  if (request[1] == '0')
-  {
-    proxy->blocking = false;
-    return true;
-  }
-  else if (request[1] == '1')
+  size_t forwarded = 0;
+
+  for (size_t i = 0; i < count; ++i)
   {
-    proxy->blocking = true;
-    return true;
+    const uint16_t time = (uint16_t)(frames[i].timestamp
+        / proxy->changes.divisor);
+
+    /* Remote frames carry no payload and are always forwarded */
+    if ((frames[i].flags & CAN_RTR)
+        || changeCacheUpdate(proxy->changes.cache, frames + i, time,
+            proxy->changes.period))
+    {
+      if (forwarded != i)
+        frames[forwarded] = frames[i];
+      ++forwarded;
+    }
+    else
+      ++proxy->changes.suppressed;
   }
-  else
-    return false;
+
+  return forwarded;
 }
 /*----------------------------------------------------------------------------*/
-static bool setCustomRate(struct CanProxy *proxy, const char *request)
+static void updateBusLoad(struct CanProxy *proxy,
+    const struct ProxyMessage *frames, size_t count)
 {
-  uint32_t rate = 0;
+  struct BusLoad * const meter = proxy->load.meter;
 
-  while (*(++request))
-    rate = (rate << 4) | hexToBin(*request);
+  proxy->load.elapsed += busLoadAdvance(meter, timerGetValue(proxy->chrono));
 
-  return ifSetParam(proxy->can, IF_RATE, &rate) == E_OK;
+  for (size_t i = 0; i < count; ++i)
+    busLoadAdd(meter, frames + i);
 }
 /*----------------------------------------------------------------------------*/
-static bool setInitialRate(struct CanProxy *proxy, const char *request)
+static void updateFilterBank(struct CanProxy *proxy)
 {
-  if (proxy->settings != NULL)
+  const struct FilterBankLayout * const layout = proxy->filter.layout;
+
+  /* Software stage checks all rules, hardware entries are a subset of them */
+  proxy->filter.software = proxy->filter.enabled;
+
+  if (layout == NULL)
+    return;
+
+  if (proxy->filter.enabled && proxy->filter.bank == NULL)
   {
-    struct Settings * const settings = proxy->settings->data;
-    const uint8_t value = hexToBin(request[1]);
+    /* Bank is kept while the proxy exists, controller may refer to it */
+    proxy->filter.bank = malloc(sizeof(struct FilterBank));
+  }
 
-    if (slcanRatePresetToValue(value))
-      settings->initial[proxy->number] = value;
-    else
-      settings->initial[proxy->number] = -1;
-    settingsSave(proxy->settings, NULL, NULL);
+  struct FilterBank * const bank = proxy->filter.bank;
 
-    return true;
+  if (proxy->filter.enabled && bank != NULL
+      && filterBankCompile(bank, layout, proxy->filter.rules)
+      && layout->program(proxy->can, bank))
+  {
+    proxy->filter.software = bank->leftovers > 0;
   }
   else
-    return false;
+  {
+    /* Controller accepts all frames, software stage does the filtering */
+    layout->program(proxy->can, NULL);
+  }
 }
 /*----------------------------------------------------------------------------*/
-static bool setPredefinedRate(struct CanProxy *proxy, const char *request)
+static uint32_t updateJobTime(struct CanProxy *proxy)
 {
-  const unsigned int code = hexToBin(request[1]);
-  const uint32_t rate = slcanRatePresetToValue(code);
+  const uint32_t elapsed = (timerGetValue(proxy->chrono)
+      - proxy->jobs.reference) / proxy->jobs.divisor;
 
-  if (rate)
-    return ifSetParam(proxy->can, IF_RATE, &rate) == E_OK;
-  else
-    return false;
+  /* Remainder of the current millisecond is kept for the next update */
+  proxy->jobs.reference += elapsed * proxy->jobs.divisor;
+  proxy->jobs.time += elapsed;
+
+  return proxy->jobs.time;
 }
 /*----------------------------------------------------------------------------*/
-static bool setRetransmissionMode(struct CanProxy *proxy, const char *request)
+static void updateJobTimer(struct CanProxy *proxy)
 {
-  if (request[1] == '0')
+  /* Cyclic frames and bus load reports need a tick every millisecond */
+  uint32_t overflow = isJobTickUsed(proxy) ? proxy->jobs.tick : 0;
+
+  if (proxy->batch.policy.pending)
   {
-    return ifSetParam(proxy->can, IF_CAN_RETRANSMISSION, &(uint8_t){0}) == E_OK;
+    /* Wakeup at the deadline of the oldest frame held back */
+    const uint32_t remaining = batchPolicyRemaining(&proxy->batch.policy,
+        timerGetValue(proxy->chrono)) / proxy->batch.divisor;
+    const uint32_t ticks = MAX((uint32_t)((uint64_t)remaining
+        * proxy->jobs.tick / 1000), 1);
+
+    overflow = overflow ? MIN(overflow, ticks) : ticks;
   }
-  else if (request[1] == '1')
+
+  if (overflow == proxy->jobs.overflow)
+    return;
+
+  timerDisable(proxy->jobs.timer);
+
+  if (overflow)
   {
-    return ifSetParam(proxy->can, IF_CAN_RETRANSMISSION, &(uint8_t){1}) == E_OK;
+    /* Period is counted from the moment of the change */
+    timerSetOverflow(proxy->jobs.timer, overflow);
+    timerSetValue(proxy->jobs.timer, 0);
+    timerEnable(proxy->jobs.timer);
   }
-  else
-    return false;
+
+  proxy->jobs.overflow = overflow;
 }
 /*----------------------------------------------------------------------------*/
-static bool setSerialNumber(struct CanProxy *proxy, const char *request)
+#ifdef ENABLE_LATENCY
+static void updateLatency(struct CanProxy *proxy)
 {
-  if (proxy->settings != NULL)
+  const uint32_t now = timerGetValue(proxy->chrono);
+
+  while (proxy->latency.count)
   {
-    struct Settings * const settings = proxy->settings->data;
+    const struct LatencySample * const sample =
+        &proxy->latency.queue[proxy->latency.head];
 
-    if (!isSerialNumberValid(settings->serial))
-    {
-      settings->serial = inPlaceHexToBin4(&request[1]);
-      settingsSave(proxy->settings, NULL, NULL);
-      return true;
-    }
+    /* Samples are ordered by the stream position */
+    if ((int32_t)(proxy->latency.sent - sample->end) < 0)
+      break;
+
+    latencyHistogramAdd(&proxy->latency.histogram,
+        (now - sample->stamp) / proxy->latency.divisor);
+
+    proxy->latency.head = (proxy->latency.head + 1) % LATENCY_QUEUE_SIZE;
+    --proxy->latency.count;
   }
+}
+#endif
+/*----------------------------------------------------------------------------*/
+static bool writeOutput(struct CanProxy *proxy, const char *buffer,
+    size_t length)
+{
+  size_t written = 0;
 
-  return false;
+  /* Data is appended to the pending output to keep the stream in order */
+  if (!proxy->output.count)
+    written = ifWrite(proxy->serial, buffer, length);
+
+#ifdef ENABLE_LATENCY
+  proxy->latency.sent += written;
+#endif
+
+  if (written == length)
+    return true;
+
+  return outputRingPush(&proxy->output, buffer + written, length - written);
+}
+/*----------------------------------------------------------------------------*/
+static void writeResponse(struct CanProxy *proxy, const char *response,
+    size_t length)
+{
+  if (!writeOutput(proxy, response, length))
+    notifyEvent(proxy, SLCAN_EVENT_SERIAL_OVERRUN);
 }
 /*----------------------------------------------------------------------------*/
 static enum Result proxyInit(void *object, const void *configBase)
@@ -697,15 +3199,81 @@ static enum Result proxyInit(void *object, const void *configBase)
 
   proxy->callback = config->callback ? config->callback : mockEventHandler;
   proxy->argument = config->argument;
-
+  proxy->dictionary = NULL;
+  proxy->jobs.wheel = NULL;
+  proxy->jobs.timer = config->jobs;
+  proxy->jobs.tick = 0;
+  proxy->jobs.overflow = 0;
+  proxy->changes.cache = NULL;
+  proxy->changes.divisor = 1;
+  proxy->changes.suppressed = 0;
+  proxy->changes.period = 0;
+  proxy->stats.table = NULL;
+  proxy->stats.hitters = NULL;
+  proxy->stats.divisor = 1;
+  proxy->filter.rules = NULL;
+  proxy->filter.layout = config->filters;
+  proxy->filter.bank = NULL;
+  proxy->filter.enabled = false;
+  proxy->filter.software = false;
+  proxy->load.meter = NULL;
+  proxy->load.elapsed = 0;
+  proxy->load.interval = 0;
+  proxy->status.received = 0;
+  proxy->status.transmitted = 0;
+  proxy->status.canOverruns = 0;
+  proxy->status.serialErrors = 0;
+  proxy->status.serialOverruns = 0;
+  proxy->status.overruns = getDriverCounter(proxy, IF_CAN_OVERRUNS);
+  proxy->status.errors = getDriverCounter(proxy, IF_CAN_RX_ERRORS)
+      + getDriverCounter(proxy, IF_CAN_TX_ERRORS);
+  proxy->status.flags = 0;
+  outputRingClear(&proxy->output);
+  proxy->sequence.next = 0;
+  proxy->sequence.enabled = false;
+  proxy->overload.rules = NULL;
+  proxy->overload.dropped[0] = 0;
+  proxy->overload.dropped[1] = 0;
+  proxy->overload.unreported[0] = 0;
+  proxy->overload.unreported[1] = 0;
+  proxy->overload.enabled = false;
+  batchPolicyDisable(&proxy->batch.policy);
+  proxy->batch.divisor = 1;
+  proxy->batch.period = 0;
+  proxy->work.profile = NULL;
+  proxy->work.divisor = 1;
+
+#ifdef ENABLE_LATENCY
+  latencyHistogramReset(&proxy->latency.histogram);
+  proxy->latency.sent = 0;
+  proxy->latency.head = 0;
+  proxy->latency.count = 0;
+  proxy->latency.divisor = proxy->chrono != NULL ?
+      MAX(timerGetFrequency(proxy->chrono) / 1000000, 1) : 1;
+#endif
+
+  proxy->format = SLCAN_FORMAT_TEXT;
   proxy->mode = SLCAN_MODE_DISABLED;
   proxy->number = config->number;
   proxy->blocking = false;
   proxy->parser.position = 0;
   proxy->parser.skip = false;
+  proxy->timestamp.divisor = 1;
+  proxy->timestamp.format = TIMESTAMP_NONE;
+  proxy->acks.accepted = 0;
+  proxy->acks.rejected = 0;
+  proxy->acks.coalesced = false;
   proxy->events.can = false;
+  proxy->events.jobs = false;
   proxy->events.serial = false;
 
+  if (proxy->jobs.timer != NULL)
+  {
+    /* Period of the timer is set when it is started */
+    proxy->jobs.tick = timerGetFrequency(proxy->jobs.timer) / 1000;
+    timerSetCallback(proxy->jobs.timer, onJobEventCallback, proxy);
+  }
+
   ifSetCallback(proxy->can, onCanEventCallback, proxy);
   ifSetCallback(proxy->serial, onSerialEventCallback, proxy);
 
@@ -718,6 +3286,27 @@ static void proxyDeinit(void *object)
 
   ifSetCallback(proxy->serial, NULL, NULL);
   ifSetCallback(proxy->can, NULL, NULL);
+
+  if (proxy->jobs.timer != NULL)
+  {
+    timerDisable(proxy->jobs.timer);
+    timerSetCallback(proxy->jobs.timer, NULL, NULL);
+  }
+
+  /* Controller should not refer to the bank after it is freed */
+  if (proxy->filter.bank != NULL)
+    proxy->filter.layout->program(proxy->can, NULL);
+
+  free(proxy->work.profile);
+  free(proxy->overload.rules);
+  free(proxy->load.meter);
+  free(proxy->stats.hitters);
+  free(proxy->stats.table);
+  free(proxy->changes.cache);
+  free(proxy->filter.bank);
+  free(proxy->filter.rules);
+  free(proxy->jobs.wheel);
+  free(proxy->dictionary);
 }
 /*----------------------------------------------------------------------------*/
 void canProxyChangeMode(struct CanProxy *proxy, enum CanProxyMode mode)
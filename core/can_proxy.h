@@ -13,6 +13,8 @@
 /*----------------------------------------------------------------------------*/
 extern const struct EntityClass * const CanProxy;
 
+struct FilterBankLayout;
+
 enum [[gnu::packed]] CanProxyEvent
 {
   SLCAN_EVENT_NONE,
@@ -24,6 +26,13 @@ enum [[gnu::packed]] CanProxyEvent
   SLCAN_EVENT_SERIAL_OVERRUN
 };
 
+enum [[gnu::packed]] CanProxyFormat
+{
+  SLCAN_FORMAT_TEXT,
+  SLCAN_FORMAT_BINARY,
+  SLCAN_FORMAT_DELTA
+};
+
 enum [[gnu::packed]] CanProxyMode
 {
   SLCAN_MODE_DISABLED,
@@ -49,6 +58,10 @@ struct CanProxyConfig
   struct Interface *can;
   struct Interface *serial;
   struct Timer *chrono;
+  /* Optional timer for periodic transmission, enabled by the proxy */
+  struct Timer *jobs;
+  /* Optional description of the acceptance filter of the controller */
+  const struct FilterBankLayout *filters;
   struct SettingsContext *settings;
 
   CanProxyCallback callback;
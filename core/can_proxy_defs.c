@@ -8,162 +8,666 @@
 #include "helpers.h"
 #include <halm/generic/can.h>
 /*----------------------------------------------------------------------------*/
-static size_t packExtFrame(void *, const struct CANStandardMessage *);
-static size_t packStdFrame(void *, const struct CANStandardMessage *);
-static bool unpackExtFrame(const void *, size_t, struct CANStandardMessage *);
-static bool unpackStdFrame(const void *, size_t, struct CANStandardMessage *);
+struct BitStream
+{
+  /* Number of bits including stuff bits */
+  uint32_t count;
+  /* CRC of the bits without stuff bits */
+  uint16_t crc;
+  /* Level and length of the current run of identical bits */
+  uint8_t level;
+  uint8_t run;
+};
+/*----------------------------------------------------------------------------*/
+static uint32_t calcFdDataLength(size_t);
+static size_t getDeltaIndex(struct DeltaDictionary *,
+    const struct ProxyMessage *, bool *);
+static size_t packData(uint8_t *, const struct ProxyMessage *);
+static size_t packDeltaFrame(struct DeltaDictionary *, void *,
+    const struct ProxyMessage *, enum TimestampFormat);
+static size_t packExtFrame(void *, const struct ProxyMessage *,
+    enum TimestampFormat);
+static size_t packStdFrame(void *, const struct ProxyMessage *,
+    enum TimestampFormat);
+static uint8_t *packTimestamp(uint8_t *, uint32_t, enum TimestampFormat);
+static char packType(uint8_t);
+static void pushBits(struct BitStream *, uint32_t, unsigned int);
+static void unpackData(const uint8_t *, uint8_t *, size_t);
+static bool unpackExtFrame(const void *, size_t, struct ProxyMessage *);
+static bool unpackPayload(const uint8_t *, size_t, uint8_t,
+    struct ProxyMessage *);
+static bool unpackStdFrame(const void *, size_t, struct ProxyMessage *);
+static uint8_t unpackType(char);
 /*----------------------------------------------------------------------------*/
-static size_t packExtFrame(void *buffer,
-    const struct CANStandardMessage *message)
+#define HEX_DIGIT(value)  ((value) < 10 ? '0' + (value) : 'A' + (value) - 10)
+#define HEX_PAIR(value)   {HEX_DIGIT((value) >> 4), HEX_DIGIT((value) & 0x0F)}
+#define HEX_ROW(value) \
+    HEX_PAIR((value) + 0x0), HEX_PAIR((value) + 0x1), \
+    HEX_PAIR((value) + 0x2), HEX_PAIR((value) + 0x3), \
+    HEX_PAIR((value) + 0x4), HEX_PAIR((value) + 0x5), \
+    HEX_PAIR((value) + 0x6), HEX_PAIR((value) + 0x7), \
+    HEX_PAIR((value) + 0x8), HEX_PAIR((value) + 0x9), \
+    HEX_PAIR((value) + 0xA), HEX_PAIR((value) + 0xB), \
+    HEX_PAIR((value) + 0xC), HEX_PAIR((value) + 0xD), \
+    HEX_PAIR((value) + 0xE), HEX_PAIR((value) + 0xF)
+
+/* Two upper-case hexadecimal characters for each byte value */
+static const char HEX_TABLE[256][2] = {
+    HEX_ROW(0x00), HEX_ROW(0x10), HEX_ROW(0x20), HEX_ROW(0x30),
+    HEX_ROW(0x40), HEX_ROW(0x50), HEX_ROW(0x60), HEX_ROW(0x70),
+    HEX_ROW(0x80), HEX_ROW(0x90), HEX_ROW(0xA0), HEX_ROW(0xB0),
+    HEX_ROW(0xC0), HEX_ROW(0xD0), HEX_ROW(0xE0), HEX_ROW(0xF0)
+};
+
+/* Data field length for each CAN FD length code */
+static const uint8_t FD_LENGTH_TABLE[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64
+};
+/*----------------------------------------------------------------------------*/
+static uint32_t calcFdDataLength(size_t length)
 {
-  uint8_t *frame = buffer;
-  uint32_t word;
+  /* Error state indicator, length code and data field with stuff bits */
+  uint32_t bits = 1 + 4 + (length << 3);
+  bits += bits >> 2;
 
-  *frame++ = (message->flags & CAN_RTR) ? 'R' : 'T';
+  /* Stuff count and CRC field with fixed stuff bits */
+  bits += length > 16 ? (4 + 21 + 7) : (4 + 17 + 6);
 
-  word = binToHex4(message->id >> 16);
-  memcpy(frame, &word, sizeof(word));
-  frame += sizeof(word);
+  return bits;
+}
+/*----------------------------------------------------------------------------*/
+static size_t getDeltaIndex(struct DeltaDictionary *dictionary,
+    const struct ProxyMessage *message, bool *found)
+{
+  static const size_t sets = DELTA_DICTIONARY_SIZE / DELTA_DICTIONARY_WAYS;
 
-  word = binToHex4(message->id);
-  memcpy(frame, &word, sizeof(word));
-  frame += sizeof(word);
+  /* Multiplicative hashing spreads sequential identifiers between sets */
+  const size_t set = ((uint32_t)(message->id * 0x9E3779B1UL) >> 16) % sets;
+  const size_t first = set * DELTA_DICTIONARY_WAYS;
+
+  for (size_t index = first; index < first + DELTA_DICTIONARY_WAYS; ++index)
+  {
+    const struct DeltaEntry * const entry = dictionary->entries + index;
+
+    if (entry->id == message->id && entry->flags == message->flags)
+    {
+      *found = true;
+      return index;
+    }
+  }
 
-  *frame++ = binToHex(message->length);
+  /* Entries of the set are replaced in round-robin order */
+  const size_t victim = dictionary->victims[set];
 
-  uint8_t * const eof = frame + message->length * 2;
+  dictionary->victims[set] = (victim + 1) % DELTA_DICTIONARY_WAYS;
+  *found = false;
+  return first + victim;
+}
+/*----------------------------------------------------------------------------*/
+static size_t packData(uint8_t *frame, const struct ProxyMessage *message)
+{
+  const size_t count = MAX(message->length, 8);
+  const size_t length = dlcToLength(lengthToDlc(message->length));
+
+  /* At least 8 bytes are converted, the buffer should hold a full frame */
+  for (size_t i = 0; i < count; ++i)
+    memcpy(frame + i * 2, HEX_TABLE[message->data[i]], 2);
+
+  /* Lengths between CAN FD length codes are padded with zero bytes */
+  for (size_t i = message->length; i < length; ++i)
+    memcpy(frame + i * 2, HEX_TABLE[0], 2);
+
+  return length * 2;
+}
+/*----------------------------------------------------------------------------*/
+static size_t packDeltaFrame(struct DeltaDictionary *dictionary, void *buffer,
+    const struct ProxyMessage *message, enum TimestampFormat format)
+{
+  /* Byte mask of the delta record covers classic data field only */
+  if (message->length > ARRAY_SIZE(dictionary->entries[0].data))
+    return packFrame(buffer, message, format);
+
+  bool found;
+  const size_t index = getDeltaIndex(dictionary, message, &found);
+  struct DeltaEntry * const entry = dictionary->entries + index;
+  uint8_t * const record = buffer;
 
-  for (size_t i = 0; i < message->length; i += 2)
+  memcpy(record + 1, HEX_TABLE[index], 2);
+
+  if (!found || entry->length != message->length
+      || entry->deltas >= DELTA_KEYFRAME_INTERVAL)
   {
-    const uint16_t pair = message->data[i + 1] | (message->data[i] << 8);
+    /* Keyframe replaces the dictionary entry with a full frame */
+    entry->id = message->id;
+    entry->flags = message->flags;
+    entry->length = message->length;
+    entry->deltas = 0;
+    memcpy(entry->data, message->data, message->length);
+
+    record[0] = 'k';
+    return DELTA_KEY_OFFSET
+        + packFrame(record + DELTA_KEY_OFFSET, message, format);
+  }
 
-    word = binToHex4(pair);
-    memcpy(frame, &word, sizeof(word));
-    frame += sizeof(word);
+  uint8_t *position = record + DELTA_KEY_OFFSET + 2;
+  uint8_t mask = 0;
+
+  if (!(message->flags & CAN_RTR))
+  {
+    /* Only changed bytes are sent, positions are marked in the byte mask */
+    for (size_t i = 0; i < message->length; ++i)
+    {
+      if (entry->data[i] != message->data[i])
+      {
+        entry->data[i] = message->data[i];
+        mask |= 1 << i;
+
+        memcpy(position, HEX_TABLE[message->data[i]], 2);
+        position += 2;
+      }
+    }
   }
 
-  *eof = '\r';
-  return (eof - (uint8_t *)buffer) + 1;
+  ++entry->deltas;
+
+  record[0] = 'x';
+  memcpy(record + DELTA_KEY_OFFSET, HEX_TABLE[mask], 2);
+  position = packTimestamp(position, message->timestamp, format);
+  *position = '\r';
+
+  return (position - record) + 1;
 }
 /*----------------------------------------------------------------------------*/
-static size_t packStdFrame(void *buffer,
-    const struct CANStandardMessage *message)
+static size_t packExtFrame(void *buffer, const struct ProxyMessage *message,
+    enum TimestampFormat format)
 {
   uint8_t *frame = buffer;
-  uint32_t word;
+  const uint32_t id = message->id;
 
-  *frame++ = (message->flags & CAN_RTR) ? 'r' : 't';
+  /* Extended frames use upper-case frame types */
+  *frame++ = packType(message->flags) - ('a' - 'A');
 
-  word = binToHex4((message->id << 4) | message->length);
-  memcpy(frame, &word, sizeof(word));
-  frame += sizeof(word);
+  memcpy(frame + 0, HEX_TABLE[(uint8_t)(id >> 24)], 2);
+  memcpy(frame + 2, HEX_TABLE[(uint8_t)(id >> 16)], 2);
+  memcpy(frame + 4, HEX_TABLE[(uint8_t)(id >> 8)], 2);
+  memcpy(frame + 6, HEX_TABLE[(uint8_t)id], 2);
+  frame[8] = binToHex(lengthToDlc(message->length));
+  frame += 9;
+
+  frame += packData(frame, message);
+  frame = packTimestamp(frame, message->timestamp, format);
+  *frame = '\r';
+
+  return (frame - (uint8_t *)buffer) + 1;
+}
+/*----------------------------------------------------------------------------*/
+static size_t packStdFrame(void *buffer, const struct ProxyMessage *message,
+    enum TimestampFormat format)
+{
+  uint8_t *frame = buffer;
+  const uint16_t joinedIdLength =
+      (message->id << 4) | lengthToDlc(message->length);
+
+  *frame++ = packType(message->flags);
 
-  uint8_t * const eof = frame + message->length * 2;
+  memcpy(frame + 0, HEX_TABLE[(uint8_t)(joinedIdLength >> 8)], 2);
+  memcpy(frame + 2, HEX_TABLE[(uint8_t)joinedIdLength], 2);
+  frame += 4;
 
-  for (size_t i = 0; i < message->length; i += 2)
+  frame += packData(frame, message);
+  frame = packTimestamp(frame, message->timestamp, format);
+  *frame = '\r';
+
+  return (frame - (uint8_t *)buffer) + 1;
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t *packTimestamp(uint8_t *frame, uint32_t timestamp,
+    enum TimestampFormat format)
+{
+  switch (format)
   {
-    const uint16_t pair = message->data[i + 1] | (message->data[i] << 8);
+    case TIMESTAMP_16_BIT:
+      memcpy(frame + 0, HEX_TABLE[(uint8_t)(timestamp >> 8)], 2);
+      memcpy(frame + 2, HEX_TABLE[(uint8_t)timestamp], 2);
+      return frame + 4;
+
+    case TIMESTAMP_32_BIT:
+      memcpy(frame + 0, HEX_TABLE[(uint8_t)(timestamp >> 24)], 2);
+      memcpy(frame + 2, HEX_TABLE[(uint8_t)(timestamp >> 16)], 2);
+      memcpy(frame + 4, HEX_TABLE[(uint8_t)(timestamp >> 8)], 2);
+      memcpy(frame + 6, HEX_TABLE[(uint8_t)timestamp], 2);
+      return frame + 8;
+
+    default:
+      return frame;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static char packType(uint8_t flags)
+{
+  if (flags & CAN_FD)
+    return (flags & CAN_BRS) ? 'b' : 'd';
+  else
+    return (flags & CAN_RTR) ? 'r' : 't';
+}
+/*----------------------------------------------------------------------------*/
+static void pushBits(struct BitStream *stream, uint32_t value,
+    unsigned int width)
+{
+  while (width--)
+  {
+    const uint8_t bit = (value >> width) & 1;
+    const bool feedback = bit ^ (stream->crc >> 14);
+
+    /* CRC-15 of Classical CAN, polynomial 0x4599 */
+    stream->crc = (stream->crc << 1) & 0x7FFF;
+    if (feedback)
+      stream->crc ^= 0x4599;
+
+    ++stream->count;
+
+    if (bit != stream->level)
+    {
+      stream->level = bit;
+      stream->run = 1;
+    }
+    else if (++stream->run == 5)
+    {
+      /* Stuff bit of the opposite level starts a new run */
+      ++stream->count;
+      stream->level = !bit;
+      stream->run = 1;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void unpackData(const uint8_t *frame, uint8_t *data, size_t length)
+{
+  size_t i = 0;
 
-    word = binToHex4(pair);
-    memcpy(frame, &word, sizeof(word));
-    frame += sizeof(word);
+  /* Input is not terminated, odd last byte is converted separately */
+  for (; i + 1 < length; i += 2)
+  {
+    const uint16_t pair = inPlaceHexToBin4(frame);
+    frame += sizeof(uint32_t);
+
+    data[i] = pair >> 8;
+    data[i + 1] = pair;
   }
 
-  *eof = '\r';
-  return (eof - (uint8_t *)buffer) + 1;
+  if (i < length)
+    data[i] = (hexToBin(frame[0]) << 4) | hexToBin(frame[1]);
 }
 /*----------------------------------------------------------------------------*/
 static bool unpackExtFrame(const void *request, size_t length,
-    struct CANStandardMessage *message)
+    struct ProxyMessage *message)
 {
   if (length < EXT_DATA_OFFSET)
     return false;
 
   const uint8_t *frame = request;
-  const char type = (char)*frame;
 
-  message->flags = type == 'R' ? (CAN_EXT_ID | CAN_RTR) : CAN_EXT_ID;
+  message->flags = unpackType((char)*frame) | CAN_EXT_ID;
   frame += sizeof(uint8_t);
   message->id = (inPlaceHexToBin4(frame) << 16) | inPlaceHexToBin4(frame + 4);
   frame += sizeof(uint32_t) * 2;
-  message->length = hexToBin(*frame);
-  frame += sizeof(uint8_t);
 
-  if (message->length > 8)
-    return false;
-  if (type == 'T' && message->length > (length - EXT_DATA_OFFSET) >> 1)
+  return unpackPayload(frame + 1, length - EXT_DATA_OFFSET, hexToBin(*frame),
+      message);
+}
+/*----------------------------------------------------------------------------*/
+static bool unpackPayload(const uint8_t *frame, size_t available, uint8_t dlc,
+    struct ProxyMessage *message)
+{
+#ifndef CONFIG_CAN_FD
+  /* Flexible data rate frames are rejected when support is disabled */
+  if (message->flags & CAN_FD)
     return false;
+#endif
 
-  for (size_t i = 0; i < message->length; i += 2)
+  if (message->flags & CAN_FD)
   {
-    const uint16_t pair = inPlaceHexToBin4(frame);
-    frame += sizeof(uint32_t);
+    if (dlc > 15)
+      return false;
+    message->length = FD_LENGTH_TABLE[dlc];
+  }
+  else
+  {
+    if (dlc > 8)
+      return false;
+    message->length = dlc;
+  }
 
-    message->data[i] = pair >> 8;
-    message->data[i + 1] = pair;
+  if (!(message->flags & CAN_RTR))
+  {
+    if (message->length > available >> 1)
+      return false;
+    unpackData(frame, message->data, message->length);
   }
 
   return true;
 }
 /*----------------------------------------------------------------------------*/
 static bool unpackStdFrame(const void *request, size_t length,
-    struct CANStandardMessage *message)
+    struct ProxyMessage *message)
 {
   if (length < STD_DATA_OFFSET)
     return false;
 
   const uint8_t *frame = request;
-  const char type = (char)*frame;
   const uint16_t joinedIdLength = inPlaceHexToBin4(frame + 1);
 
   message->id = joinedIdLength >> 4;
-  message->flags = type == 'r' ? CAN_RTR : 0;
-  message->length = joinedIdLength & 0x000F;
+  message->flags = unpackType((char)*frame);
 
-  if (message->length > 8)
-    return false;
-  if (type == 't' && message->length > (length - STD_DATA_OFFSET) >> 1)
-    return false;
+  return unpackPayload(frame + STD_DATA_OFFSET, length - STD_DATA_OFFSET,
+      joinedIdLength & 0x000F, message);
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t unpackType(char type)
+{
+  /* Frame type is case-insensitive here, case selects the identifier type */
+  switch (type | ('a' - 'A'))
+  {
+    case 'r':
+      return CAN_RTR;
+
+    case 'd':
+      return CAN_FD;
+
+    case 'b':
+      return CAN_FD | CAN_BRS;
 
-  frame += STD_DATA_OFFSET;
-  for (size_t i = 0; i < message->length; i += 2)
+    default:
+      return 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint32_t calcDataPhaseLength(uint8_t flags, size_t length)
+{
+  static const uint8_t mask = CAN_FD | CAN_BRS;
+
+  /* Only the data phase of frames with bit rate switching is accelerated */
+  return (flags & mask) == mask ? calcFdDataLength(length) : 0;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t calcFrameLength(uint8_t flags, size_t length)
+{
+  uint32_t bits;
+
+  if (flags & CAN_FD)
   {
-    const uint16_t pair = inPlaceHexToBin4(frame);
-    frame += sizeof(uint32_t);
+    /* Arbitration field with stuff bits */
+    bits = (flags & CAN_EXT_ID) ? 36 : 17;
+    bits += (bits - 1) >> 2;
+    /* CRC delimiter, acknowledge, end of frame and interframe spacing */
+    bits += 1 + 2 + 7 + 3;
+
+    /* Data phase is calculated separately when bit rate switch is enabled */
+    if (!(flags & CAN_BRS))
+      bits += calcFdDataLength(length);
+  }
+  else
+  {
+    /* System fields */
+    bits = (flags & CAN_EXT_ID) ? 64 : 44;
+    /* Data field */
+    bits += (flags & CAN_RTR) ? 0 : (length << 3);
+    /* Bit stuffing */
+    bits += (bits - 11) >> 2;
+    /* Interframe spacing */
+    bits += 3;
+  }
+
+  return bits;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t calcStuffedLength(const struct ProxyMessage *message,
+    uint32_t *dataPhaseLength)
+{
+  const bool extended = (message->flags & CAN_EXT_ID) != 0;
+  const bool fd = (message->flags & CAN_FD) != 0;
+  const bool brs = fd && (message->flags & CAN_BRS);
+  const bool rtr = !fd && (message->flags & CAN_RTR);
+  /* Level of the previous bit is unknown before the start of frame */
+  struct BitStream stream = {0, 0, 2, 0};
+
+  /* Start of frame and arbitration field */
+  pushBits(&stream, 0, 1);
 
-    message->data[i] = pair >> 8;
-    message->data[i + 1] = pair;
+  if (extended)
+  {
+    pushBits(&stream, message->id >> 18, 11);
+    /* Substitute remote request and identifier extension */
+    pushBits(&stream, 3, 2);
+    pushBits(&stream, message->id, 18);
+    /* Remote request or remote request substitution */
+    pushBits(&stream, rtr, 1);
+
+    /* Reserved bit r1 of Classical CAN frames */
+    if (!fd)
+      pushBits(&stream, 0, 1);
+  }
+  else
+  {
+    pushBits(&stream, message->id, 11);
+    /* Remote request or remote request substitution, identifier extension */
+    pushBits(&stream, rtr << 1, 2);
   }
 
-  return true;
+  /* Reserved bit r0 or FD format indicator */
+  pushBits(&stream, fd, 1);
+
+  uint32_t nominal = 0;
+
+  if (fd)
+  {
+    /* Reserved bit and bit rate switch */
+    pushBits(&stream, brs, 2);
+
+    if (brs)
+    {
+      nominal = stream.count;
+      stream.count = 0;
+    }
+
+    /* Error state indicator */
+    pushBits(&stream, 0, 1);
+  }
+
+  /* Control field and data field */
+  pushBits(&stream, lengthToDlc(message->length), 4);
+  if (!rtr)
+  {
+    for (size_t i = 0; i < message->length; ++i)
+      pushBits(&stream, message->data[i], 8);
+  }
+
+  if (fd)
+  {
+    /* Stuff count and CRC field with fixed stuff bits */
+    stream.count += message->length > 16 ? (4 + 21 + 7) : (4 + 17 + 6);
+  }
+  else
+  {
+    /* CRC sequence is also subject to bit stuffing */
+    pushBits(&stream, stream.crc, 15);
+  }
+
+  /* CRC delimiter, acknowledge, end of frame and interframe spacing */
+  static const uint32_t trailer = 1 + 2 + 7 + 3;
+
+  if (brs)
+  {
+    *dataPhaseLength = stream.count;
+    return nominal + trailer;
+  }
+  else
+  {
+    *dataPhaseLength = 0;
+    return stream.count + trailer;
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint8_t dlcToLength(uint8_t dlc)
+{
+  return FD_LENGTH_TABLE[dlc & 0x0F];
+}
+/*----------------------------------------------------------------------------*/
+size_t getBinaryFrameLength(uint8_t header)
+{
+  const uint8_t dlc = header & BIN_LENGTH_MASK;
+  size_t total = BIN_DATA_OFFSET;
+
+#ifndef CONFIG_CAN_FD
+  /* Flexible data rate frames are rejected when support is disabled */
+  if (header & BIN_FLAG_FD)
+    return 0;
+#endif
+
+  if (header & BIN_FLAG_FD)
+    total += FD_LENGTH_TABLE[dlc];
+  else
+  {
+    if (dlc > 8)
+      return 0;
+    if (!(header & BIN_FLAG_RTR))
+      total += dlc;
+  }
+
+  if (header & BIN_FLAG_TS)
+    total += sizeof(uint32_t);
+
+  return total;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t lengthToDlc(uint8_t length)
+{
+  uint8_t dlc = MIN(length, 8);
+
+  /* Round up to the nearest length supported by CAN FD */
+  while (FD_LENGTH_TABLE[dlc] < length && dlc < 15)
+    ++dlc;
+
+  return dlc;
 }
 /*----------------------------------------------------------------------------*/
-uint32_t calcFrameLength(uint8_t flags, size_t dlc)
+size_t packBinaryDrops(void *buffer, uint32_t mandatory, uint32_t optional)
 {
-  uint32_t length = 0;
+  /* Record of a standard frame with 8 data bytes and a flagged identifier */
+  const uint32_t words[] = {
+      toLittleEndian32(BIN_ID_DROPS),
+      toLittleEndian32(mandatory),
+      toLittleEndian32(optional)
+  };
+  uint8_t * const record = buffer;
 
-  /* System fields */
-  length += (flags & CAN_EXT_ID) ? 64 : 44;
-  /* Data field */
-  length += (flags & CAN_RTR) ? 0 : (dlc << 3);
-  /* Bit stuffing */
-  length += (length - 11) >> 2;
-  /* Interframe spacing */
-  length += 3;
+  record[0] = BIN_FRAME_MARKER;
+  record[1] = lengthToDlc(BIN_DROPS_LENGTH - BIN_DATA_OFFSET);
+  memcpy(record + 2, words, sizeof(words));
+
+  return BIN_DROPS_LENGTH;
+}
+/*----------------------------------------------------------------------------*/
+size_t packBinaryFrame(void *buffer, const struct ProxyMessage *message,
+    bool timestamp)
+{
+  uint8_t *frame = buffer;
+  uint8_t header = lengthToDlc(message->length);
+  bool data = true;
+  uint32_t word;
+
+  if (message->flags & CAN_EXT_ID)
+    header |= BIN_FLAG_EXT;
+
+  if (message->flags & CAN_FD)
+  {
+    header |= BIN_FLAG_FD;
+    if (message->flags & CAN_BRS)
+      header |= BIN_FLAG_BRS;
+  }
+  else if (message->flags & CAN_RTR)
+  {
+    header |= BIN_FLAG_RTR;
+    data = false;
+  }
+
+  if (timestamp)
+    header |= BIN_FLAG_TS;
+
+  *frame++ = BIN_FRAME_MARKER;
+  *frame++ = header;
+
+  word = toLittleEndian32(message->id);
+  memcpy(frame, &word, sizeof(word));
+  frame += sizeof(word);
+
+  if (data)
+  {
+    const size_t length = dlcToLength(header & BIN_LENGTH_MASK);
+
+    /* Lengths between CAN FD length codes are padded with zero bytes */
+    memcpy(frame, message->data, message->length);
+    memset(frame + message->length, 0, length - message->length);
+    frame += length;
+  }
+
+  if (timestamp)
+  {
+    word = toLittleEndian32(message->timestamp);
+    memcpy(frame, &word, sizeof(word));
+    frame += sizeof(word);
+  }
+
+  return frame - (uint8_t *)buffer;
+}
+/*----------------------------------------------------------------------------*/
+size_t packDeltaFrames(struct DeltaDictionary *dictionary, void *buffer,
+    const struct ProxyMessage *messages, size_t count,
+    enum TimestampFormat format)
+{
+  uint8_t * const records = buffer;
+  size_t length = 0;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    length += packDeltaFrame(dictionary, records + length, messages + i,
+        format);
+  }
 
   return length;
 }
 /*----------------------------------------------------------------------------*/
-size_t packFrame(void *buffer, const struct CANStandardMessage *message)
+size_t packFrame(void *buffer, const struct ProxyMessage *message,
+    enum TimestampFormat format)
 {
   if (message->flags & CAN_EXT_ID)
   {
-    return packExtFrame(buffer, message);
+    return packExtFrame(buffer, message, format);
   }
   else
   {
-    return packStdFrame(buffer, message);
+    return packStdFrame(buffer, message, format);
+  }
+}
+/*----------------------------------------------------------------------------*/
+size_t packFrames(void *buffer, const struct ProxyMessage *messages,
+    size_t count, enum TimestampFormat format)
+{
+  uint8_t * const frames = buffer;
+  size_t length = 0;
+  size_t index = 0;
+
+  /* Runs of frames with the same identifier type use separate loops */
+  while (index < count)
+  {
+    while (index < count && !(messages[index].flags & CAN_EXT_ID))
+      length += packStdFrame(frames + length, messages + index++, format);
+    while (index < count && (messages[index].flags & CAN_EXT_ID))
+      length += packExtFrame(frames + length, messages + index++, format);
   }
+
+  return length;
 }
 /*----------------------------------------------------------------------------*/
 size_t packNumber4(void *buffer, char prefix, uint8_t value)
@@ -189,17 +693,144 @@ size_t packNumber16(void *buffer, char prefix, uint16_t value)
   return sizeof(response);
 }
 /*----------------------------------------------------------------------------*/
-bool unpackFrame(const void *buffer, size_t length,
-    struct CANStandardMessage *message)
+size_t packSequence(void *buffer, size_t length, uint16_t sequence,
+    bool binary)
 {
-  const char * const request = buffer;
+  uint8_t * const record = buffer;
 
-  if (request[0] == 'T' || request[0] == 'R')
+  if (binary)
   {
-    return unpackExtFrame(request, length, message);
+    const uint16_t word = toLittleEndian16(sequence);
+    uint32_t id;
+
+    /* Record announces the sequence field with a spare identifier bit */
+    memcpy(&id, record + 2, sizeof(id));
+    id = toLittleEndian32(fromLittleEndian32(id) | BIN_ID_SEQUENCE);
+    memcpy(record + 2, &id, sizeof(id));
+
+    memcpy(record + length, &word, sizeof(word));
+    return length + SEQ_BIN_LENGTH;
   }
   else
   {
-    return unpackStdFrame(request, length, message);
+    /* Separator and sequence number replace the end of the record */
+    record[length - 1] = SEQ_TEXT_SEPARATOR;
+    inPlaceBinToHex4(record + length, sequence);
+    record[length + SEQ_TEXT_LENGTH - 1] = '\r';
+    return length + SEQ_TEXT_LENGTH;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void resetDeltaDictionary(struct DeltaDictionary *dictionary)
+{
+  /* Length of empty entries never matches, first frames become keyframes */
+  for (size_t i = 0; i < ARRAY_SIZE(dictionary->entries); ++i)
+    dictionary->entries[i].length = UINT8_MAX;
+  for (size_t i = 0; i < ARRAY_SIZE(dictionary->victims); ++i)
+    dictionary->victims[i] = 0;
+}
+/*----------------------------------------------------------------------------*/
+bool unpackBinaryDrops(const void *buffer, size_t length, uint32_t *counters)
+{
+  const uint8_t * const record = buffer;
+  uint32_t words[3];
+
+  if (length != BIN_DROPS_LENGTH || record[0] != BIN_FRAME_MARKER
+      || record[1] != lengthToDlc(BIN_DROPS_LENGTH - BIN_DATA_OFFSET))
+  {
+    return false;
+  }
+
+  memcpy(words, record + 2, sizeof(words));
+  if (fromLittleEndian32(words[0]) != BIN_ID_DROPS)
+    return false;
+
+  counters[0] = fromLittleEndian32(words[1]);
+  counters[1] = fromLittleEndian32(words[2]);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool unpackBinaryFrame(const void *buffer, size_t length,
+    struct ProxyMessage *message)
+{
+  const uint8_t *frame = buffer;
+
+  if (length < BIN_DATA_OFFSET || frame[0] != BIN_FRAME_MARKER)
+    return false;
+  if (getBinaryFrameLength(frame[1]) != length)
+    return false;
+
+  const uint8_t header = frame[1];
+  const uint8_t dlc = header & BIN_LENGTH_MASK;
+  bool data = true;
+  uint32_t word;
+
+  memcpy(&word, frame + 2, sizeof(word));
+  frame += BIN_DATA_OFFSET;
+
+  message->id = fromLittleEndian32(word);
+  message->flags = 0;
+
+  if (header & BIN_FLAG_EXT)
+  {
+    if (message->id > 0x1FFFFFFFUL)
+      return false;
+    message->flags |= CAN_EXT_ID;
+  }
+  else
+  {
+    if (message->id > 0x7FF)
+      return false;
+  }
+
+  if (header & BIN_FLAG_FD)
+  {
+    message->flags |= CAN_FD;
+    if (header & BIN_FLAG_BRS)
+      message->flags |= CAN_BRS;
+    message->length = FD_LENGTH_TABLE[dlc];
+  }
+  else
+  {
+    if (header & BIN_FLAG_RTR)
+    {
+      message->flags |= CAN_RTR;
+      data = false;
+    }
+    message->length = dlc;
+  }
+
+  if (data)
+  {
+    memcpy(message->data, frame, message->length);
+    frame += message->length;
+  }
+
+  if (header & BIN_FLAG_TS)
+  {
+    memcpy(&word, frame, sizeof(word));
+    message->timestamp = fromLittleEndian32(word);
+  }
+  else
+    message->timestamp = 0;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool unpackFrame(const void *buffer, size_t length,
+    struct ProxyMessage *message)
+{
+  const char * const request = buffer;
+
+  switch (request[0])
+  {
+    case 'B':
+    case 'D':
+    case 'R':
+    case 'T':
+      return unpackExtFrame(request, length, message);
+
+    default:
+      return unpackStdFrame(request, length, message);
   }
 }
@@ -11,15 +11,94 @@
 #include <stddef.h>
 #include <stdint.h>
 /*----------------------------------------------------------------------------*/
-struct CANStandardMessage;
+#ifdef CONFIG_CAN_FD
+/* Data field of CAN FD frames */
+#  define FRAME_DATA_MAX  64
+#else
+#  define FRAME_DATA_MAX  8
+#endif
 
 /* Type (1) + ID (4 * 2) + Length (1) */
 #define EXT_DATA_OFFSET (1 + 4 * 2 + 1)
-/* Data Offset + Data (2 * 8) + EOF (1) */
-#define EXT_MAX_LENGTH  (EXT_DATA_OFFSET + 2 * 8 + 1)
+/* Data Offset + Data (2 * N) + Timestamp (8) + EOF (1) */
+#define EXT_MAX_LENGTH  (EXT_DATA_OFFSET + 2 * FRAME_DATA_MAX + 8 + 1)
 /* Type (1) + ID (3) + Length (1) */
 #define STD_DATA_OFFSET (1 + 3 + 1)
 
+/* Marker (1) + Flags and length (1) + ID (4) */
+#define BIN_DATA_OFFSET (1 + 1 + 4)
+/* Data Offset + Data (N) + Timestamp (4) */
+#define BIN_MAX_LENGTH  (BIN_DATA_OFFSET + FRAME_DATA_MAX + 4)
+
+/* Separator (1) + Number (4) in text records, Number (2) in binary records */
+#define SEQ_TEXT_LENGTH   (1 + 4)
+#define SEQ_BIN_LENGTH    2
+/* Separator of the sequence number field in text and delta records */
+#define SEQ_TEXT_SEPARATOR ':'
+
+/* First byte of a binary frame record */
+#define BIN_FRAME_MARKER  0xA5
+/* Single byte record that switches the stream back to the text mode */
+#define BIN_RESET_MARKER  0x5A
+
+/* Bit fields of the second byte of a binary frame record */
+#define BIN_LENGTH_MASK   0x0F
+#define BIN_FLAG_EXT      0x10
+/* Remote frame for classic frames or bit rate switch for CAN FD frames */
+#define BIN_FLAG_RTR      0x20
+#define BIN_FLAG_BRS      0x20
+#define BIN_FLAG_TS       0x40
+#define BIN_FLAG_FD       0x80
+/* Spare bit of the identifier word, set when a sequence number follows */
+#define BIN_ID_SEQUENCE   0x80000000UL
+/* Spare bit of the identifier word, set in drop marker records */
+#define BIN_ID_DROPS      0x40000000UL
+/* Marker (1) + Flags and length (1) + ID (4) + Drop counters (4 * 2) */
+#define BIN_DROPS_LENGTH  (BIN_DATA_OFFSET + 4 * 2)
+
+/* Status flags of the F command, latched until they are read */
+#define STATUS_RX_FULL    0x01
+#define STATUS_TX_FULL    0x02
+#define STATUS_OVERRUN    0x08
+#define STATUS_BUS_ERROR  0x80
+
+/* Record type (1) + Dictionary index (2) */
+#define DELTA_KEY_OFFSET  3
+/* Delta records sent for a dictionary entry before the next keyframe */
+#define DELTA_KEYFRAME_INTERVAL 32
+/* Entries of the dictionary with the same index hash */
+#define DELTA_DICTIONARY_WAYS   4
+
+enum [[gnu::packed]] TimestampFormat
+{
+  TIMESTAMP_NONE,
+  TIMESTAMP_16_BIT,
+  TIMESTAMP_32_BIT
+};
+
+/*
+ * Layout matches CANStandardMessage when CAN FD support is disabled and
+ * CANMessage with a 64-byte data field otherwise.
+ */
+struct ProxyMessage
+{
+  uint32_t timestamp;
+  uint32_t id;
+  uint8_t flags;
+  uint8_t length;
+  uint8_t data[FRAME_DATA_MAX];
+};
+
+/* Last frame sent with the dictionary index of the delta stream */
+struct DeltaEntry
+{
+  uint32_t id;
+  uint8_t flags;
+  uint8_t length;
+  uint8_t deltas;
+  uint8_t data[8];
+};
+
 struct [[gnu::packed]] PackedNumber16
 {
   uint8_t prefix;
@@ -27,25 +106,61 @@ struct [[gnu::packed]] PackedNumber16
   uint8_t eof;
 };
 
-#define RESPONSE_MTU          sizeof(struct PackedNumber16)
+/* Prefix (1) + Four 16-bit numbers (4 * 4) + EOF (1) */
+#define RESPONSE_MTU          (1 + 4 * 4 + 1)
 #define SERIALIZED_FRAME_MTU  EXT_MAX_LENGTH
 
+/* Command (1) + Index (2) + Period (4) + Count (4) + Phase (4) */
+#define CYCLIC_JOB_OFFSET     (1 + 2 + 4 * 3)
+/* Longest command is a periodic frame with a frame in the text format */
+#define COMMAND_MTU           (CYCLIC_JOB_OFFSET + SERIALIZED_FRAME_MTU)
+
 #ifdef CONFIG_SERIAL_HS
 /* Serial over High-Speed USB */
 #  define SERIAL_MTU            512
 #  define SERIALIZED_QUEUE_SIZE 16
+#  define DELTA_DICTIONARY_SIZE 256
 #else
 #  define SERIAL_MTU            64
 #  define SERIALIZED_QUEUE_SIZE 2
+#  define DELTA_DICTIONARY_SIZE 64
 #endif
+
+/* Serial buffer for frames packed with their exact length */
+#define SERIALIZED_BATCH_SIZE \
+    ((SERIALIZED_FRAME_MTU + DELTA_KEY_OFFSET) * SERIALIZED_QUEUE_SIZE)
+/* Maximum number of frames in a single serial write */
+#define SERIALIZED_BATCH_FRAMES (SERIALIZED_QUEUE_SIZE * 4)
+
+struct DeltaDictionary
+{
+  struct DeltaEntry entries[DELTA_DICTIONARY_SIZE];
+  /* Next entry to be replaced in each set */
+  uint8_t victims[DELTA_DICTIONARY_SIZE / DELTA_DICTIONARY_WAYS];
+};
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
+uint32_t calcDataPhaseLength(uint8_t, size_t);
 uint32_t calcFrameLength(uint8_t, size_t);
-size_t packFrame(void *, const struct CANStandardMessage *);
+uint32_t calcStuffedLength(const struct ProxyMessage *, uint32_t *);
+uint8_t dlcToLength(uint8_t);
+size_t getBinaryFrameLength(uint8_t);
+uint8_t lengthToDlc(uint8_t);
+size_t packBinaryDrops(void *, uint32_t, uint32_t);
+size_t packBinaryFrame(void *, const struct ProxyMessage *, bool);
+size_t packDeltaFrames(struct DeltaDictionary *, void *,
+    const struct ProxyMessage *, size_t, enum TimestampFormat);
+size_t packFrame(void *, const struct ProxyMessage *, enum TimestampFormat);
+size_t packFrames(void *, const struct ProxyMessage *, size_t,
+    enum TimestampFormat);
 size_t packNumber4(void *, char, uint8_t);
 size_t packNumber16(void *, char, uint16_t);
-bool unpackFrame(const void *, size_t, struct CANStandardMessage *);
+size_t packSequence(void *, size_t, uint16_t, bool);
+void resetDeltaDictionary(struct DeltaDictionary *);
+bool unpackBinaryDrops(const void *, size_t, uint32_t *);
+bool unpackBinaryFrame(const void *, size_t, struct ProxyMessage *);
+bool unpackFrame(const void *, size_t, struct ProxyMessage *);
 
 END_DECLS
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,137 @@
+/*
+ * core/change_cache.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "change_cache.h"
+#include <halm/generic/can.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static struct ChangeEntry *findExtEntry(struct ChangeCache *, uint32_t,
+    bool *);
+static struct ChangeEntry *findStdEntry(struct ChangeCache *, uint32_t,
+    bool *);
+static void packPayload(uint8_t *, const struct ProxyMessage *);
+/*----------------------------------------------------------------------------*/
+static_assert(CHANGE_CACHE_SIZE < CHANGE_CACHE_NONE, "Incorrect cache size");
+/*----------------------------------------------------------------------------*/
+static struct ChangeEntry *findExtEntry(struct ChangeCache *cache,
+    uint32_t id, bool *found)
+{
+  static const size_t sets = CHANGE_CACHE_SIZE / CHANGE_CACHE_WAYS;
+
+  const size_t set = ((uint32_t)(id * 0x9E3779B1UL) >> 16) % sets;
+  struct ChangeEntry * const first = cache->extended + set * CHANGE_CACHE_WAYS;
+
+  for (size_t way = 0; way < CHANGE_CACHE_WAYS; ++way)
+  {
+    if (first[way].id == id)
+    {
+      *found = true;
+      return first + way;
+    }
+  }
+
+  /* Entries of the set are replaced in round-robin order */
+  const size_t victim = cache->victims[set];
+
+  cache->victims[set] = (victim + 1) % CHANGE_CACHE_WAYS;
+  *found = false;
+  return first + victim;
+}
+/*----------------------------------------------------------------------------*/
+static struct ChangeEntry *findStdEntry(struct ChangeCache *cache,
+    uint32_t id, bool *found)
+{
+  const uint8_t index = cache->standard[id];
+
+  if (index != CHANGE_CACHE_NONE)
+  {
+    *found = true;
+    return cache->pool + index;
+  }
+
+  uint8_t slot;
+
+  if (cache->used < CHANGE_CACHE_SIZE)
+  {
+    slot = cache->used++;
+  }
+  else
+  {
+    /* Pool is full, the owner of the victim entry loses its state */
+    slot = cache->victim;
+    cache->victim = (slot + 1) % CHANGE_CACHE_SIZE;
+    cache->standard[cache->pool[slot].id] = CHANGE_CACHE_NONE;
+  }
+
+  cache->standard[id] = slot;
+  *found = false;
+  return cache->pool + slot;
+}
+/*----------------------------------------------------------------------------*/
+static void packPayload(uint8_t *buffer, const struct ProxyMessage *message)
+{
+  if (message->length <= 8)
+  {
+    memset(buffer, 0, 8);
+    memcpy(buffer, message->data, message->length);
+  }
+  else
+  {
+    /* 64-bit FNV-1a digest of long CAN FD payloads */
+    uint64_t digest = 0xCBF29CE484222325ULL;
+
+    for (size_t i = 0; i < message->length; ++i)
+      digest = (digest ^ message->data[i]) * 0x100000001B3ULL;
+
+    memcpy(buffer, &digest, sizeof(digest));
+  }
+}
+/*----------------------------------------------------------------------------*/
+void changeCacheReset(struct ChangeCache *cache)
+{
+  memset(cache->standard, CHANGE_CACHE_NONE, sizeof(cache->standard));
+  memset(cache->victims, 0, sizeof(cache->victims));
+
+  /* Extended identifiers are 29 bits wide, all-ones marks an empty entry */
+  for (size_t i = 0; i < ARRAY_SIZE(cache->extended); ++i)
+    cache->extended[i].id = UINT32_MAX;
+
+  cache->victim = 0;
+  cache->used = 0;
+}
+/*----------------------------------------------------------------------------*/
+bool changeCacheUpdate(struct ChangeCache *cache,
+    const struct ProxyMessage *message, uint16_t time, uint16_t period)
+{
+  const bool extended = (message->flags & CAN_EXT_ID) != 0;
+  const uint32_t id = extended ? message->id : (message->id & 0x7FF);
+  struct ChangeEntry *entry;
+  uint8_t payload[8];
+  bool found;
+
+  if (extended)
+    entry = findExtEntry(cache, id, &found);
+  else
+    entry = findStdEntry(cache, id, &found);
+
+  packPayload(payload, message);
+
+  if (found && entry->flags == message->flags
+      && entry->length == message->length
+      && !memcmp(entry->data, payload, sizeof(payload))
+      && (!period || (uint16_t)(time - entry->time) < period))
+  {
+    return false;
+  }
+
+  entry->id = id;
+  entry->time = time;
+  entry->flags = message->flags;
+  entry->length = message->length;
+  memcpy(entry->data, payload, sizeof(payload));
+
+  return true;
+}
@@ -0,0 +1,57 @@
+/*
+ * core/change_cache.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_CHANGE_CACHE_H_
+#define CORE_CHANGE_CACHE_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_SERIAL_HS
+#  define CHANGE_CACHE_SIZE 128
+#else
+#  define CHANGE_CACHE_SIZE 32
+#endif
+
+#define CHANGE_CACHE_WAYS   4
+/* Index of the empty entry in the table of standard identifiers */
+#define CHANGE_CACHE_NONE   UINT8_MAX
+
+struct ChangeEntry
+{
+  uint32_t id;
+  /* Time of the last forwarded frame in milliseconds */
+  uint16_t time;
+  uint8_t flags;
+  uint8_t length;
+  /* Payload or digest of the payload for frames longer than 8 bytes */
+  uint8_t data[8];
+};
+
+struct ChangeCache
+{
+  /* Direct-indexed table of standard identifiers */
+  uint8_t standard[2048];
+  /* Entries of standard identifiers */
+  struct ChangeEntry pool[CHANGE_CACHE_SIZE];
+  /* Set-associative hash table of extended identifiers */
+  struct ChangeEntry extended[CHANGE_CACHE_SIZE];
+
+  /* Next entry to be replaced in the pool and in each extended set */
+  uint8_t victim;
+  uint8_t victims[CHANGE_CACHE_SIZE / CHANGE_CACHE_WAYS];
+  /* Number of allocated entries of the pool */
+  uint8_t used;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void changeCacheReset(struct ChangeCache *);
+bool changeCacheUpdate(struct ChangeCache *, const struct ProxyMessage *,
+    uint16_t, uint16_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_CHANGE_CACHE_H_ */
@@ -0,0 +1,231 @@
+/*
+ * core/filter_bank.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "filter_bank.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+struct FilterCover
+{
+  uint32_t id;
+  uint32_t mask;
+  size_t count;
+};
+
+struct CompilerState
+{
+  struct FilterBank *bank;
+  const struct FilterBankLayout *layout;
+
+  /* Slots available for wanted entries */
+  size_t budget;
+  /* Slots opened so far */
+  size_t used;
+  /* Number of entries of each kind */
+  size_t counts[FILTER_KIND_END];
+
+  /* Catch-all entries for standard and extended leftovers */
+  struct FilterCover cover[2];
+};
+/*----------------------------------------------------------------------------*/
+static bool appendEntry(struct CompilerState *, enum FilterEntryKind,
+    uint32_t, uint32_t);
+static bool compilePass(struct FilterBank *, const struct FilterBankLayout *,
+    const struct IdFilter *, size_t);
+static void placeItem(struct CompilerState *, bool, uint32_t, uint32_t);
+static void placeRange(struct CompilerState *, bool, uint32_t, uint32_t);
+static void sortEntries(struct FilterBank *);
+/*----------------------------------------------------------------------------*/
+static bool appendEntry(struct CompilerState *state, enum FilterEntryKind kind,
+    uint32_t id, uint32_t mask)
+{
+  struct FilterBank * const bank = state->bank;
+  const size_t perSlot = state->layout->entries[kind];
+
+  if (!perSlot || bank->count == ARRAY_SIZE(bank->entries))
+    return false;
+
+  if (state->counts[kind] == (size_t)bank->slots[kind] * perSlot)
+  {
+    /* All slots of this kind are full, a new slot should be opened */
+    if (state->used == state->budget)
+      return false;
+
+    ++state->used;
+    ++bank->slots[kind];
+  }
+
+  bank->entries[bank->count++] = (struct FilterBankEntry){
+      .id = id,
+      .mask = mask,
+      .kind = kind
+  };
+  ++state->counts[kind];
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static bool compilePass(struct FilterBank *bank,
+    const struct FilterBankLayout *layout, const struct IdFilter *filter,
+    size_t reserved)
+{
+  if (reserved > layout->slots)
+    return false;
+
+  struct CompilerState state = {
+      .bank = bank,
+      .layout = layout,
+      .budget = layout->slots - reserved
+  };
+
+  memset(bank->slots, 0, sizeof(bank->slots));
+  bank->count = 0;
+  bank->leftovers = 0;
+
+  /* Wanted entries are placed in the order of rules, first rules win */
+  if (filter->legacy.enabled)
+  {
+    const uint32_t code = filter->legacy.code;
+    const uint32_t mask = filter->legacy.mask;
+
+    placeItem(&state, false, code & ~mask & ID_FILTER_STD_MASK,
+        mask & ID_FILTER_STD_MASK);
+    placeItem(&state, true, code & ~mask & ID_FILTER_EXT_MASK,
+        mask & ID_FILTER_EXT_MASK);
+  }
+
+  for (size_t i = 0; i < filter->count; ++i)
+  {
+    const struct IdFilterRule * const rule = filter->rules + i;
+
+    if (rule->type == ID_FILTER_RANGE)
+      placeRange(&state, rule->extended, rule->first, rule->second);
+    else
+      placeItem(&state, rule->extended, rule->first & ~rule->second,
+          rule->second);
+  }
+
+  /* Leftovers are accepted by wider mask entries in reserved slots */
+  for (size_t i = 0; i < ARRAY_SIZE(state.cover); ++i)
+  {
+    if (!state.cover[i].count)
+      continue;
+
+    state.budget = layout->slots;
+
+    if (!appendEntry(&state, i ? FILTER_EXT_MASK : FILTER_STD_MASK,
+        state.cover[i].id & ~state.cover[i].mask, state.cover[i].mask))
+    {
+      return false;
+    }
+
+    bank->leftovers += state.cover[i].count;
+  }
+
+  sortEntries(bank);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void placeItem(struct CompilerState *state, bool extended, uint32_t id,
+    uint32_t mask)
+{
+  const enum FilterEntryKind list =
+      extended ? FILTER_EXT_ID : FILTER_STD_ID;
+  const enum FilterEntryKind kind =
+      extended ? FILTER_EXT_MASK : FILTER_STD_MASK;
+  bool placed;
+
+  if (!mask && state->layout->entries[list])
+  {
+    /* Exact identifiers use list entries when the controller has them */
+    placed = appendEntry(state, list, id, 0);
+  }
+  else
+    placed = appendEntry(state, kind, id, mask);
+
+  if (placed)
+  {
+    /* Range of a mask with gaps also covers identifiers between the blocks */
+    if ((mask & (mask + 1)) != 0 && state->layout->ranges)
+      ++state->bank->leftovers;
+  }
+  else
+  {
+    struct FilterCover * const cover = &state->cover[extended];
+
+    if (!cover->count)
+    {
+      cover->id = id;
+      cover->mask = mask;
+    }
+    else
+      cover->mask |= mask | (id ^ cover->id);
+
+    ++cover->count;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void placeRange(struct CompilerState *state, bool extended,
+    uint32_t low, uint32_t high)
+{
+  /* Range is split into the minimal set of aligned power-of-two blocks */
+  while (true)
+  {
+    uint32_t mask = 0;
+
+    while (true)
+    {
+      const uint32_t wider = (mask << 1) | 1;
+
+      if ((low & wider) || (low | wider) > high)
+        break;
+
+      mask = wider;
+    }
+
+    placeItem(state, extended, low, mask);
+
+    if ((low | mask) == high)
+      break;
+
+    low = (low | mask) + 1;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void sortEntries(struct FilterBank *bank)
+{
+  /* Stable insertion sort by entry kind and identifier */
+  for (size_t i = 1; i < bank->count; ++i)
+  {
+    const struct FilterBankEntry entry = bank->entries[i];
+    size_t j = i;
+
+    while (j > 0 && (bank->entries[j - 1].kind > entry.kind
+        || (bank->entries[j - 1].kind == entry.kind
+            && bank->entries[j - 1].id > entry.id)))
+    {
+      bank->entries[j] = bank->entries[j - 1];
+      --j;
+    }
+
+    bank->entries[j] = entry;
+  }
+}
+/*----------------------------------------------------------------------------*/
+bool filterBankCompile(struct FilterBank *bank,
+    const struct FilterBankLayout *layout, const struct IdFilter *filter)
+{
+  /*
+   * Try to place all wanted entries without catch-all entries first,
+   * then reserve slots for catch-all entries of one or both identifier types.
+   */
+  for (size_t reserved = 0; reserved <= 2; ++reserved)
+  {
+    if (compilePass(bank, layout, filter, reserved))
+      return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,78 @@
+/*
+ * core/filter_bank.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_FILTER_BANK_H_
+#define CORE_FILTER_BANK_H_
+/*----------------------------------------------------------------------------*/
+#include "id_filter.h"
+/*----------------------------------------------------------------------------*/
+/* Maximum number of hardware entries produced by the compiler */
+#define FILTER_BANK_CAPACITY  128
+
+struct FilterBank;
+struct Interface;
+
+/*
+ * Writes entries to the controller, NULL bank disables hardware filtering.
+ * Bank remains valid and unchanged until the next call of the callback.
+ */
+typedef bool (*FilterBankCallback)(struct Interface *,
+    const struct FilterBank *);
+
+enum [[gnu::packed]] FilterEntryKind
+{
+  FILTER_STD_ID,
+  FILTER_EXT_ID,
+  FILTER_STD_MASK,
+  FILTER_EXT_MASK,
+
+  FILTER_KIND_END
+};
+
+struct FilterBankLayout
+{
+  FilterBankCallback program;
+
+  /* Number of filter slots of the controller */
+  uint8_t slots;
+  /* Number of entries of each kind in one slot, zero when unsupported */
+  uint8_t entries[FILTER_KIND_END];
+  /* Mask entries are programmed as ranges from the lowest to the highest ID */
+  bool ranges;
+};
+
+struct FilterBankEntry
+{
+  uint32_t id;
+  /* Ignored identifier bits, zero for identifier list entries */
+  uint32_t mask;
+  enum FilterEntryKind kind;
+};
+
+struct FilterBank
+{
+  /*
+   * Entries are grouped by kind in the order of the kind enumeration
+   * and sorted by identifier within each group.
+   */
+  struct FilterBankEntry entries[FILTER_BANK_CAPACITY];
+  size_t count;
+
+  /* Number of slots used by each kind of entries */
+  uint8_t slots[FILTER_KIND_END];
+
+  /* Number of wanted entries accepted by wider entries */
+  size_t leftovers;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool filterBankCompile(struct FilterBank *, const struct FilterBankLayout *,
+    const struct IdFilter *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_FILTER_BANK_H_ */
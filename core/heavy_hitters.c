@@ -0,0 +1,260 @@
+/*
+ * core/heavy_hitters.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "heavy_hitters.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+#define INDEX_MASK  (HEAVY_HITTERS_SIZE * 2 - 1)
+/*----------------------------------------------------------------------------*/
+static void attachCounter(struct HeavyHitters *, uint8_t, uint8_t);
+static void detachCounter(struct HeavyHitters *, uint8_t);
+static size_t findSlot(const struct HeavyHitters *, uint32_t);
+static size_t getHomeSlot(uint32_t);
+static void incrementCounter(struct HeavyHitters *, uint8_t);
+static void releaseBucket(struct HeavyHitters *, uint8_t);
+static void removeSlot(struct HeavyHitters *, size_t);
+static uint8_t reserveBucket(struct HeavyHitters *, uint32_t, uint8_t);
+/*----------------------------------------------------------------------------*/
+static_assert(HEAVY_HITTERS_SIZE < HEAVY_HITTERS_NONE,
+    "Incorrect number of counters");
+static_assert((HEAVY_HITTERS_SIZE & (HEAVY_HITTERS_SIZE - 1)) == 0,
+    "Number of counters should be a power of two");
+/*----------------------------------------------------------------------------*/
+static void attachCounter(struct HeavyHitters *sketch, uint8_t counter,
+    uint8_t bucket)
+{
+  struct HitterCounter * const entry = sketch->counters + counter;
+  const uint8_t first = sketch->buckets[bucket].first;
+
+  entry->bucket = bucket;
+  entry->prev = HEAVY_HITTERS_NONE;
+  entry->next = first;
+
+  if (first != HEAVY_HITTERS_NONE)
+    sketch->counters[first].prev = counter;
+  sketch->buckets[bucket].first = counter;
+}
+/*----------------------------------------------------------------------------*/
+static void detachCounter(struct HeavyHitters *sketch, uint8_t counter)
+{
+  const struct HitterCounter * const entry = sketch->counters + counter;
+
+  if (entry->prev != HEAVY_HITTERS_NONE)
+    sketch->counters[entry->prev].next = entry->next;
+  else
+    sketch->buckets[entry->bucket].first = entry->next;
+
+  if (entry->next != HEAVY_HITTERS_NONE)
+    sketch->counters[entry->next].prev = entry->prev;
+}
+/*----------------------------------------------------------------------------*/
+static size_t findSlot(const struct HeavyHitters *sketch, uint32_t id)
+{
+  size_t slot = getHomeSlot(id);
+
+  /* Index is never full, the search ends at the first empty slot */
+  while (sketch->index[slot] != HEAVY_HITTERS_NONE
+      && sketch->counters[sketch->index[slot]].id != id)
+  {
+    slot = (slot + 1) & INDEX_MASK;
+  }
+
+  return slot;
+}
+/*----------------------------------------------------------------------------*/
+static size_t getHomeSlot(uint32_t id)
+{
+  return ((uint32_t)(id * 0x9E3779B1UL) >> 16) & INDEX_MASK;
+}
+/*----------------------------------------------------------------------------*/
+static void incrementCounter(struct HeavyHitters *sketch, uint8_t counter)
+{
+  const uint8_t bucket = sketch->counters[counter].bucket;
+  const uint32_t value = sketch->buckets[bucket].value + 1;
+  const uint8_t next = sketch->buckets[bucket].next;
+
+  if (next != HEAVY_HITTERS_NONE && sketch->buckets[next].value == value)
+  {
+    /* Move the counter to the following bucket */
+    detachCounter(sketch, counter);
+    attachCounter(sketch, counter, next);
+
+    if (sketch->buckets[bucket].first == HEAVY_HITTERS_NONE)
+      releaseBucket(sketch, bucket);
+  }
+  else if (sketch->buckets[bucket].first == counter
+      && sketch->counters[counter].next == HEAVY_HITTERS_NONE)
+  {
+    /* Single counter of the bucket, the bucket is updated in place */
+    sketch->buckets[bucket].value = value;
+  }
+  else
+  {
+    detachCounter(sketch, counter);
+    attachCounter(sketch, counter, reserveBucket(sketch, value, bucket));
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void releaseBucket(struct HeavyHitters *sketch, uint8_t bucket)
+{
+  const struct HitterBucket * const entry = sketch->buckets + bucket;
+
+  if (entry->prev != HEAVY_HITTERS_NONE)
+    sketch->buckets[entry->prev].next = entry->next;
+  else
+    sketch->head = entry->next;
+
+  if (entry->next != HEAVY_HITTERS_NONE)
+    sketch->buckets[entry->next].prev = entry->prev;
+  else
+    sketch->tail = entry->prev;
+
+  sketch->buckets[bucket].next = sketch->spare;
+  sketch->spare = bucket;
+}
+/*----------------------------------------------------------------------------*/
+static void removeSlot(struct HeavyHitters *sketch, size_t slot)
+{
+  size_t next = slot;
+
+  /* Backward shift deletion keeps probe sequences without tombstones */
+  while (true)
+  {
+    next = (next + 1) & INDEX_MASK;
+
+    if (sketch->index[next] == HEAVY_HITTERS_NONE)
+      break;
+
+    const size_t home = getHomeSlot(sketch->counters[sketch->index[next]].id);
+
+    /* Entry may be moved when its home slot is not between the slots */
+    if (((next - home) & INDEX_MASK) >= ((next - slot) & INDEX_MASK))
+    {
+      sketch->index[slot] = sketch->index[next];
+      slot = next;
+    }
+  }
+
+  sketch->index[slot] = HEAVY_HITTERS_NONE;
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t reserveBucket(struct HeavyHitters *sketch, uint32_t value,
+    uint8_t prev)
+{
+  const uint8_t bucket = sketch->spare;
+  struct HitterBucket * const entry = sketch->buckets + bucket;
+
+  /* Number of buckets never exceeds the number of counters */
+  sketch->spare = entry->next;
+
+  entry->value = value;
+  entry->first = HEAVY_HITTERS_NONE;
+  entry->prev = prev;
+
+  if (prev != HEAVY_HITTERS_NONE)
+  {
+    entry->next = sketch->buckets[prev].next;
+    sketch->buckets[prev].next = bucket;
+  }
+  else
+  {
+    entry->next = sketch->head;
+    sketch->head = bucket;
+  }
+
+  if (entry->next != HEAVY_HITTERS_NONE)
+    sketch->buckets[entry->next].prev = bucket;
+  else
+    sketch->tail = bucket;
+
+  return bucket;
+}
+/*----------------------------------------------------------------------------*/
+size_t heavyHittersGetTop(const struct HeavyHitters *sketch,
+    struct HitterEstimate *estimates, size_t offset, size_t count)
+{
+  size_t position = 0;
+  size_t written = 0;
+
+  /* Buckets are visited from the highest count to the lowest one */
+  for (uint8_t bucket = sketch->tail; bucket != HEAVY_HITTERS_NONE
+      && written < count; bucket = sketch->buckets[bucket].prev)
+  {
+    const struct HitterBucket * const entry = sketch->buckets + bucket;
+
+    for (uint8_t counter = entry->first; counter != HEAVY_HITTERS_NONE
+        && written < count; counter = sketch->counters[counter].next)
+    {
+      if (position++ < offset)
+        continue;
+
+      estimates[written++] = (struct HitterEstimate){
+          .id = sketch->counters[counter].id,
+          .count = entry->value,
+          .error = sketch->counters[counter].error
+      };
+    }
+  }
+
+  return written;
+}
+/*----------------------------------------------------------------------------*/
+void heavyHittersReset(struct HeavyHitters *sketch)
+{
+  memset(sketch->index, HEAVY_HITTERS_NONE, sizeof(sketch->index));
+
+  for (size_t i = 0; i < ARRAY_SIZE(sketch->buckets); ++i)
+    sketch->buckets[i].next = (uint8_t)(i + 1);
+  sketch->buckets[ARRAY_SIZE(sketch->buckets) - 1].next = HEAVY_HITTERS_NONE;
+
+  sketch->total = 0;
+  sketch->used = 0;
+  sketch->head = HEAVY_HITTERS_NONE;
+  sketch->tail = HEAVY_HITTERS_NONE;
+  sketch->spare = 0;
+}
+/*----------------------------------------------------------------------------*/
+void heavyHittersUpdate(struct HeavyHitters *sketch, uint32_t id)
+{
+  const size_t slot = findSlot(sketch, id);
+  uint8_t counter = sketch->index[slot];
+
+  sketch->total += sketch->total < UINT32_MAX;
+
+  if (counter != HEAVY_HITTERS_NONE)
+  {
+    incrementCounter(sketch, counter);
+    return;
+  }
+
+  if (sketch->used < HEAVY_HITTERS_SIZE)
+  {
+    /* Unused counter joins the bucket of single occurrences */
+    counter = sketch->used++;
+    sketch->counters[counter].id = id;
+    sketch->counters[counter].error = 0;
+
+    uint8_t bucket = sketch->head;
+
+    if (bucket == HEAVY_HITTERS_NONE || sketch->buckets[bucket].value != 1)
+      bucket = reserveBucket(sketch, 1, HEAVY_HITTERS_NONE);
+
+    attachCounter(sketch, counter, bucket);
+    sketch->index[slot] = counter;
+  }
+  else
+  {
+    /* Counter with the lowest count is taken over by the new identifier */
+    counter = sketch->buckets[sketch->head].first;
+
+    removeSlot(sketch, findSlot(sketch, sketch->counters[counter].id));
+    sketch->counters[counter].id = id;
+    sketch->counters[counter].error = sketch->buckets[sketch->head].value;
+    sketch->index[findSlot(sketch, id)] = counter;
+
+    incrementCounter(sketch, counter);
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * core/heavy_hitters.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_HEAVY_HITTERS_H_
+#define CORE_HEAVY_HITTERS_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_SERIAL_HS
+#  define HEAVY_HITTERS_SIZE  128
+#  define HEAVY_HITTERS_PAGE  16
+#else
+#  define HEAVY_HITTERS_SIZE  64
+#  define HEAVY_HITTERS_PAGE  4
+#endif
+
+/* Type (1) + Identifier (8) + Count (8) + Error (8) + EOL (1) */
+#define HEAVY_HITTERS_RECORD  (1 + 8 * 3 + 1)
+/* Index of the empty list or entry */
+#define HEAVY_HITTERS_NONE    UINT8_MAX
+
+struct HitterCounter
+{
+  uint32_t id;
+  /* Maximal overestimation of the count */
+  uint32_t error;
+
+  /* Bucket of the counter and neighbours in the list of the bucket */
+  uint8_t bucket;
+  uint8_t prev;
+  uint8_t next;
+};
+
+struct HitterBucket
+{
+  /* Count shared by all counters of the bucket */
+  uint32_t value;
+
+  /* First counter of the bucket and neighbours in the list of buckets */
+  uint8_t first;
+  uint8_t prev;
+  uint8_t next;
+};
+
+struct HitterEstimate
+{
+  uint32_t id;
+  uint32_t count;
+  uint32_t error;
+};
+
+struct HeavyHitters
+{
+  struct HitterCounter counters[HEAVY_HITTERS_SIZE];
+  struct HitterBucket buckets[HEAVY_HITTERS_SIZE];
+  /* Hash index of identifiers, open addressing with linear probing */
+  uint8_t index[HEAVY_HITTERS_SIZE * 2];
+
+  /* Number of processed frames */
+  uint32_t total;
+  /* Number of counters in use */
+  uint8_t used;
+
+  /* Buckets with the lowest and the highest counts */
+  uint8_t head;
+  uint8_t tail;
+  /* List of unused buckets */
+  uint8_t spare;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+size_t heavyHittersGetTop(const struct HeavyHitters *, struct HitterEstimate *,
+    size_t, size_t);
+void heavyHittersReset(struct HeavyHitters *);
+void heavyHittersUpdate(struct HeavyHitters *, uint32_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_HEAVY_HITTERS_H_ */
@@ -30,6 +30,44 @@ static inline void inPlaceBinToHex4(void *buffer, uint16_t value)
   memcpy(buffer, &converted, sizeof(converted));
 }
 
+static inline void inPlaceBinToHex8(void *buffer, uint32_t value)
+{
+  inPlaceBinToHex4(buffer, (uint16_t)(value >> 16));
+  inPlaceBinToHex4((uint8_t *)buffer + 4, (uint16_t)value);
+}
+
+static inline uint32_t findZeroByte32(uint32_t value)
+{
+  return (value - 0x01010101UL) & ~value & 0x80808080UL;
+}
+
+static inline size_t findLineEnd(const void *buffer, size_t length)
+{
+  const uint8_t * const input = buffer;
+  size_t index = 0;
+
+  /* Skip whole words without carriage return and line feed characters */
+  for (; index + sizeof(uint32_t) <= length; index += sizeof(uint32_t))
+  {
+    uint32_t word;
+    memcpy(&word, input + index, sizeof(word));
+
+    if (findZeroByte32(word ^ 0x0D0D0D0DUL)
+        | findZeroByte32(word ^ 0x0A0A0A0AUL))
+    {
+      break;
+    }
+  }
+
+  for (; index < length; ++index)
+  {
+    if (input[index] == '\r' || input[index] == '\n')
+      break;
+  }
+
+  return index;
+}
+
 static inline uint8_t hexToBin(uint8_t code)
 {
   code &= 0xCF;
@@ -0,0 +1,215 @@
+/*
+ * core/id_filter.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "id_filter.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static bool addRule(struct IdFilter *, enum IdFilterType, bool,
+    uint32_t, uint32_t);
+static void compileFilter(struct IdFilter *);
+static void insertRange(struct IdFilter *, uint32_t, uint32_t);
+static void setStandardMask(struct IdFilter *, uint32_t, uint32_t);
+static void setStandardRange(struct IdFilter *, uint32_t, uint32_t);
+/*----------------------------------------------------------------------------*/
+static bool addRule(struct IdFilter *filter, enum IdFilterType type,
+    bool extended, uint32_t first, uint32_t second)
+{
+  if (filter->count == ARRAY_SIZE(filter->rules))
+    return false;
+
+  filter->rules[filter->count++] = (struct IdFilterRule){
+      .first = first,
+      .second = second,
+      .type = type,
+      .extended = extended
+  };
+
+  compileFilter(filter);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void compileFilter(struct IdFilter *filter)
+{
+  memset(filter->standard, 0, sizeof(filter->standard));
+  filter->rangeCount = 0;
+  filter->maskCount = 0;
+
+  if (filter->legacy.enabled)
+  {
+    setStandardMask(filter, filter->legacy.code, filter->legacy.mask);
+    filter->masks[filter->maskCount++] = (struct IdFilterRule){
+        .first = filter->legacy.code,
+        .second = filter->legacy.mask,
+        .type = ID_FILTER_MASK,
+        .extended = true
+    };
+  }
+
+  for (size_t i = 0; i < filter->count; ++i)
+  {
+    const struct IdFilterRule * const rule = filter->rules + i;
+
+    if (rule->extended)
+    {
+      if (rule->type == ID_FILTER_RANGE)
+        insertRange(filter, rule->first, rule->second);
+      else
+        filter->masks[filter->maskCount++] = *rule;
+    }
+    else
+    {
+      if (rule->type == ID_FILTER_RANGE)
+        setStandardRange(filter, rule->first, rule->second);
+      else
+        setStandardMask(filter, rule->first, rule->second);
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void insertRange(struct IdFilter *filter, uint32_t low, uint32_t high)
+{
+  size_t position = 0;
+
+  /* Find the first range that ends at or after the new range starts */
+  while (position < filter->rangeCount
+      && filter->ranges[position].high < low
+      && filter->ranges[position].high + 1 != low)
+  {
+    ++position;
+  }
+
+  /* Absorb all ranges overlapping or adjacent to the new range */
+  size_t last = position;
+
+  while (last < filter->rangeCount
+      && (filter->ranges[last].low <= high
+          || filter->ranges[last].low == high + 1))
+  {
+    low = MIN(low, filter->ranges[last].low);
+    high = MAX(high, filter->ranges[last].high);
+    ++last;
+  }
+
+  if (last == position)
+  {
+    memmove(filter->ranges + position + 1, filter->ranges + position,
+        (filter->rangeCount - position) * sizeof(struct IdFilterRange));
+    ++filter->rangeCount;
+  }
+  else if (last > position + 1)
+  {
+    memmove(filter->ranges + position + 1, filter->ranges + last,
+        (filter->rangeCount - last) * sizeof(struct IdFilterRange));
+    filter->rangeCount -= last - position - 1;
+  }
+
+  filter->ranges[position] = (struct IdFilterRange){low, high};
+}
+/*----------------------------------------------------------------------------*/
+static void setStandardMask(struct IdFilter *filter, uint32_t code,
+    uint32_t mask)
+{
+  const uint32_t care = ~mask & ID_FILTER_STD_MASK;
+
+  code &= care;
+
+  for (uint32_t id = 0; id <= ID_FILTER_STD_MASK; ++id)
+  {
+    if ((id & care) == code)
+      filter->standard[id >> 5] |= 1UL << (id & 31);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void setStandardRange(struct IdFilter *filter, uint32_t low,
+    uint32_t high)
+{
+  for (uint32_t id = low; id <= high; ++id)
+    filter->standard[id >> 5] |= 1UL << (id & 31);
+}
+/*----------------------------------------------------------------------------*/
+bool idFilterAddMask(struct IdFilter *filter, bool extended, uint32_t code,
+    uint32_t mask)
+{
+  const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+
+  if (code > limit)
+    return false;
+
+  return addRule(filter, ID_FILTER_MASK, extended, code, mask & limit);
+}
+/*----------------------------------------------------------------------------*/
+bool idFilterAddRange(struct IdFilter *filter, bool extended, uint32_t low,
+    uint32_t high)
+{
+  const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+
+  if (low > high || high > limit)
+    return false;
+
+  return addRule(filter, ID_FILTER_RANGE, extended, low, high);
+}
+/*----------------------------------------------------------------------------*/
+void idFilterClear(struct IdFilter *filter)
+{
+  filter->count = 0;
+  filter->legacy.code = 0;
+  filter->legacy.mask = UINT32_MAX;
+  filter->legacy.enabled = false;
+
+  compileFilter(filter);
+}
+/*----------------------------------------------------------------------------*/
+bool idFilterMatch(const struct IdFilter *filter, uint32_t id, bool extended)
+{
+  if (!extended)
+  {
+    id &= ID_FILTER_STD_MASK;
+    return (filter->standard[id >> 5] >> (id & 31)) & 1;
+  }
+
+  /* Binary search for the last range starting at or before the identifier */
+  size_t low = 0;
+  size_t high = filter->rangeCount;
+
+  while (low < high)
+  {
+    const size_t middle = (low + high) / 2;
+
+    if (filter->ranges[middle].low <= id)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  if (low > 0 && id <= filter->ranges[low - 1].high)
+    return true;
+
+  for (size_t i = 0; i < filter->maskCount; ++i)
+  {
+    const struct IdFilterRule * const rule = filter->masks + i;
+
+    if (((id ^ rule->first) & ~rule->second & ID_FILTER_EXT_MASK) == 0)
+      return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+void idFilterSetCode(struct IdFilter *filter, uint32_t code)
+{
+  filter->legacy.code = code;
+  filter->legacy.enabled = true;
+
+  compileFilter(filter);
+}
+/*----------------------------------------------------------------------------*/
+void idFilterSetMask(struct IdFilter *filter, uint32_t mask)
+{
+  filter->legacy.mask = mask;
+  filter->legacy.enabled = true;
+
+  compileFilter(filter);
+}
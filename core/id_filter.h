@@ -0,0 +1,80 @@
+/*
+ * core/id_filter.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_ID_FILTER_H_
+#define CORE_ID_FILTER_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+#define ID_FILTER_CAPACITY  32
+
+#define ID_FILTER_STD_MASK  0x000007FFUL
+#define ID_FILTER_EXT_MASK  0x1FFFFFFFUL
+
+enum [[gnu::packed]] IdFilterType
+{
+  ID_FILTER_RANGE,
+  ID_FILTER_MASK
+};
+
+struct IdFilterRule
+{
+  /* Lower bound of the range or acceptance code */
+  uint32_t first;
+  /* Upper bound of the range or acceptance mask */
+  uint32_t second;
+
+  enum IdFilterType type;
+  bool extended;
+};
+
+struct IdFilterRange
+{
+  uint32_t low;
+  uint32_t high;
+};
+
+struct IdFilter
+{
+  /* Rules in the order they were added */
+  struct IdFilterRule rules[ID_FILTER_CAPACITY];
+  size_t count;
+
+  /* Acceptance code and mask for both identifier types */
+  struct
+  {
+    uint32_t code;
+    uint32_t mask;
+    bool enabled;
+  } legacy;
+
+  /* Compiled lookup bitmap for standard identifiers */
+  uint32_t standard[(ID_FILTER_STD_MASK + 1) / 32];
+
+  /* Sorted and merged ranges of extended identifiers */
+  struct IdFilterRange ranges[ID_FILTER_CAPACITY];
+  size_t rangeCount;
+
+  /* Code and mask pairs for extended identifiers, mask bits are ignored */
+  struct IdFilterRule masks[ID_FILTER_CAPACITY + 1];
+  size_t maskCount;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool idFilterAddMask(struct IdFilter *, bool, uint32_t, uint32_t);
+bool idFilterAddRange(struct IdFilter *, bool, uint32_t, uint32_t);
+void idFilterClear(struct IdFilter *);
+bool idFilterMatch(const struct IdFilter *, uint32_t, bool);
+void idFilterSetCode(struct IdFilter *, uint32_t);
+void idFilterSetMask(struct IdFilter *, uint32_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_ID_FILTER_H_ */
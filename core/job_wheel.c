@@ -0,0 +1,132 @@
+/*
+ * core/job_wheel.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "job_wheel.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static void insertJob(struct JobWheel *, size_t);
+static void unlinkJob(struct JobWheel *, size_t);
+/*----------------------------------------------------------------------------*/
+static void insertJob(struct JobWheel *wheel, size_t index)
+{
+  struct CyclicJob * const job = wheel->jobs + index;
+  const size_t slot = job->deadline % JOB_WHEEL_SLOTS;
+
+  job->next = wheel->slots[slot];
+  wheel->slots[slot] = (uint8_t)index;
+}
+/*----------------------------------------------------------------------------*/
+static void unlinkJob(struct JobWheel *wheel, size_t index)
+{
+  const size_t slot = wheel->jobs[index].deadline % JOB_WHEEL_SLOTS;
+  uint8_t *link = &wheel->slots[slot];
+
+  while (*link != JOB_WHEEL_NONE)
+  {
+    if (*link == index)
+    {
+      *link = wheel->jobs[index].next;
+      break;
+    }
+
+    link = &wheel->jobs[*link].next;
+  }
+}
+/*----------------------------------------------------------------------------*/
+bool jobWheelAdd(struct JobWheel *wheel, size_t index,
+    const struct ProxyMessage *message, uint16_t period, uint16_t count,
+    uint16_t phase)
+{
+  if (index >= JOB_WHEEL_CAPACITY || !period)
+    return false;
+
+  struct CyclicJob * const job = wheel->jobs + index;
+
+  if (job->active)
+    unlinkJob(wheel, index);
+  else
+    ++wheel->count;
+
+  job->message = *message;
+  job->deadline = wheel->time + 1 + phase;
+  job->period = period;
+  job->remaining = count;
+  job->active = true;
+
+  insertJob(wheel, index);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void jobWheelAdvance(struct JobWheel *wheel, uint32_t now,
+    JobCallback callback, void *argument)
+{
+  if (!wheel->count)
+  {
+    /* Time of an idle wheel is synchronized without processing of slots */
+    wheel->time = now;
+    return;
+  }
+
+  while (wheel->time != now)
+  {
+    const size_t slot = ++wheel->time % JOB_WHEEL_SLOTS;
+    uint8_t index = wheel->slots[slot];
+
+    /* Detach the list, jobs with the same slot are inserted again */
+    wheel->slots[slot] = JOB_WHEEL_NONE;
+
+    while (index != JOB_WHEEL_NONE)
+    {
+      struct CyclicJob * const job = wheel->jobs + index;
+      const uint8_t next = job->next;
+
+      if (job->deadline == wheel->time)
+      {
+        callback(argument, &job->message);
+
+        if (job->remaining && !--job->remaining)
+        {
+          job->active = false;
+          --wheel->count;
+        }
+        else
+          job->deadline += job->period;
+      }
+
+      if (job->active)
+        insertJob(wheel, index);
+
+      index = next;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+void jobWheelClear(struct JobWheel *wheel)
+{
+  for (size_t i = 0; i < ARRAY_SIZE(wheel->jobs); ++i)
+    wheel->jobs[i].active = false;
+
+  memset(wheel->slots, JOB_WHEEL_NONE, sizeof(wheel->slots));
+  wheel->count = 0;
+}
+/*----------------------------------------------------------------------------*/
+void jobWheelInit(struct JobWheel *wheel, uint32_t now)
+{
+  jobWheelClear(wheel);
+  wheel->time = now;
+}
+/*----------------------------------------------------------------------------*/
+bool jobWheelRemove(struct JobWheel *wheel, size_t index)
+{
+  if (index >= JOB_WHEEL_CAPACITY || !wheel->jobs[index].active)
+    return false;
+
+  unlinkJob(wheel, index);
+  wheel->jobs[index].active = false;
+  --wheel->count;
+
+  return true;
+}
@@ -0,0 +1,63 @@
+/*
+ * core/job_wheel.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_JOB_WHEEL_H_
+#define CORE_JOB_WHEEL_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_SERIAL_HS
+#  define JOB_WHEEL_CAPACITY  64
+#else
+#  define JOB_WHEEL_CAPACITY  16
+#endif
+
+/* Number of wheel slots, each slot corresponds to one tick */
+#define JOB_WHEEL_SLOTS       64
+/* Index of the empty list */
+#define JOB_WHEEL_NONE        UINT8_MAX
+
+typedef void (*JobCallback)(void *, const struct ProxyMessage *);
+
+struct CyclicJob
+{
+  struct ProxyMessage message;
+
+  /* Tick of the next transmission */
+  uint32_t deadline;
+  /* Period in ticks */
+  uint16_t period;
+  /* Remaining transmissions, zero for infinite jobs */
+  uint16_t remaining;
+
+  /* Next job in the list of the wheel slot */
+  uint8_t next;
+  bool active;
+};
+
+struct JobWheel
+{
+  struct CyclicJob jobs[JOB_WHEEL_CAPACITY];
+  uint8_t slots[JOB_WHEEL_SLOTS];
+
+  /* Last processed tick */
+  uint32_t time;
+  /* Number of active jobs */
+  size_t count;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool jobWheelAdd(struct JobWheel *, size_t, const struct ProxyMessage *,
+    uint16_t, uint16_t, uint16_t);
+void jobWheelAdvance(struct JobWheel *, uint32_t, JobCallback, void *);
+void jobWheelClear(struct JobWheel *);
+void jobWheelInit(struct JobWheel *, uint32_t);
+bool jobWheelRemove(struct JobWheel *, size_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_JOB_WHEEL_H_ */
@@ -0,0 +1,27 @@
+/*
+ * core/latency_histogram.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "latency_histogram.h"
+#include <xcore/bits.h>
+/*----------------------------------------------------------------------------*/
+void latencyHistogramAdd(struct LatencyHistogram *histogram, uint32_t latency)
+{
+  /* Latencies of 0 and 1 us share the first bin */
+  const size_t bin = latency > 1 ? 31 - countLeadingZeros32(latency) : 0;
+
+  ++histogram->bins[MIN(bin, LATENCY_HISTOGRAM_BINS - 1)];
+
+  if (latency > histogram->max)
+    histogram->max = latency;
+}
+/*----------------------------------------------------------------------------*/
+void latencyHistogramReset(struct LatencyHistogram *histogram)
+{
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BINS; ++i)
+    histogram->bins[i] = 0;
+
+  histogram->max = 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * core/latency_histogram.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_LATENCY_HISTOGRAM_H_
+#define CORE_LATENCY_HISTOGRAM_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+/* Bin N holds latencies from 2^N to 2^(N+1) - 1 us, the last bin is open */
+#define LATENCY_HISTOGRAM_BINS    20
+/* Type (1) + Bins (8 * N) + Maximal latency (8) + EOL (1) */
+#define LATENCY_HISTOGRAM_RECORD  (1 + 8 * LATENCY_HISTOGRAM_BINS + 8 + 1)
+
+struct LatencyHistogram
+{
+  uint32_t bins[LATENCY_HISTOGRAM_BINS];
+  /* Maximal latency in microseconds */
+  uint32_t max;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void latencyHistogramAdd(struct LatencyHistogram *, uint32_t);
+void latencyHistogramReset(struct LatencyHistogram *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_LATENCY_HISTOGRAM_H_ */
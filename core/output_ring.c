@@ -0,0 +1,46 @@
+/*
+ * core/output_ring.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "output_ring.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+void outputRingClear(struct OutputRing *ring)
+{
+  ring->head = 0;
+  ring->count = 0;
+}
+/*----------------------------------------------------------------------------*/
+size_t outputRingPeek(const struct OutputRing *ring, const char **data)
+{
+  /* Only the contiguous part up to the end of the storage is returned */
+  *data = ring->data + ring->head;
+  return MIN(ring->count, OUTPUT_RING_SIZE - ring->head);
+}
+/*----------------------------------------------------------------------------*/
+bool outputRingPush(struct OutputRing *ring, const char *data, size_t length)
+{
+  /* Records are never split, a record that does not fit is rejected */
+  if (length > OUTPUT_RING_SIZE - ring->count)
+    return false;
+
+  const size_t tail = (ring->head + ring->count) % OUTPUT_RING_SIZE;
+  const size_t chunk = MIN(length, OUTPUT_RING_SIZE - tail);
+
+  memcpy(ring->data + tail, data, chunk);
+  memcpy(ring->data, data + chunk, length - chunk);
+  ring->count += length;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void outputRingSkip(struct OutputRing *ring, size_t length)
+{
+  ring->head = (ring->head + length) % OUTPUT_RING_SIZE;
+  ring->count -= length;
+
+  if (!ring->count)
+    ring->head = 0;
+}
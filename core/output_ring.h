@@ -0,0 +1,40 @@
+/*
+ * core/output_ring.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_OUTPUT_RING_H_
+#define CORE_OUTPUT_RING_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+/* Space for responses queued behind a batch of frames */
+#ifdef CONFIG_SERIAL_HS
+#  define OUTPUT_RING_RESERVE 1024
+#else
+#  define OUTPUT_RING_RESERVE 256
+#endif
+
+#define OUTPUT_RING_SIZE  (SERIALIZED_BATCH_SIZE + OUTPUT_RING_RESERVE)
+
+struct OutputRing
+{
+  char data[OUTPUT_RING_SIZE];
+
+  /* Position of the oldest pending byte */
+  size_t head;
+  /* Number of pending bytes */
+  size_t count;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void outputRingClear(struct OutputRing *);
+size_t outputRingPeek(const struct OutputRing *, const char **);
+bool outputRingPush(struct OutputRing *, const char *, size_t);
+void outputRingSkip(struct OutputRing *, size_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_OUTPUT_RING_H_ */
@@ -65,6 +65,8 @@ bool proxyPortInitTemplate(struct ProxyPort *port,
       .can = config->can,
       .serial = config->serial,
       .chrono = config->chrono,
+      .jobs = config->jobs,
+      .filters = config->filters,
       .settings = config->settings,
       .callback = onProxyEvent,
       .argument = port,
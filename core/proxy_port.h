@@ -17,6 +17,8 @@ struct ProxyPortConfig
   struct Interface *can;
   struct Interface *serial;
   struct Timer *chrono;
+  struct Timer *jobs;
+  const struct FilterBankLayout *filters;
   struct Indicator *error;
   struct Indicator *status;
   struct SettingsContext *settings;
@@ -0,0 +1,80 @@
+/*
+ * core/traffic_stats.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "traffic_stats.h"
+#include <halm/generic/can.h>
+/*----------------------------------------------------------------------------*/
+static_assert((TRAFFIC_STATS_SIZE & (TRAFFIC_STATS_SIZE - 1)) == 0,
+    "Table size should be a power of two");
+/*----------------------------------------------------------------------------*/
+void trafficStatsReset(struct TrafficStats *stats)
+{
+  for (size_t i = 0; i < ARRAY_SIZE(stats->entries); ++i)
+    stats->entries[i].id = TRAFFIC_STATS_NONE;
+
+  stats->count = 0;
+  stats->overflows = 0;
+}
+/*----------------------------------------------------------------------------*/
+void trafficStatsUpdate(struct TrafficStats *stats,
+    const struct ProxyMessage *message)
+{
+  const uint32_t id = (message->flags & CAN_EXT_ID) ?
+      (message->id | TRAFFIC_STATS_EXT) : (message->id & 0x7FF);
+  size_t index = (uint32_t)(id * 0x9E3779B1UL) >> 16;
+  struct TrafficEntry *entry;
+
+  /* Linear probing, the table always has empty entries */
+  while (true)
+  {
+    index &= TRAFFIC_STATS_SIZE - 1;
+    entry = stats->entries + index;
+
+    if (entry->id == id)
+      break;
+
+    if (entry->id == TRAFFIC_STATS_NONE)
+    {
+      if (stats->count == TRAFFIC_STATS_LIMIT)
+      {
+        ++stats->overflows;
+        return;
+      }
+
+      ++stats->count;
+      entry->id = id;
+      entry->count = 0;
+      break;
+    }
+
+    ++index;
+  }
+
+  if (entry->count)
+  {
+    const uint32_t gap = message->timestamp - entry->last;
+
+    if (entry->count == 1)
+    {
+      entry->minGap = gap;
+      entry->maxGap = gap;
+    }
+    else
+    {
+      entry->minGap = MIN(entry->minGap, gap);
+      entry->maxGap = MAX(entry->maxGap, gap);
+    }
+  }
+  else
+  {
+    entry->minGap = 0;
+    entry->maxGap = 0;
+  }
+
+  entry->count += entry->count < UINT32_MAX;
+  entry->last = message->timestamp;
+  entry->dlc = lengthToDlc(message->length);
+}
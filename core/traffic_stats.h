@@ -0,0 +1,60 @@
+/*
+ * core/traffic_stats.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_TRAFFIC_STATS_H_
+#define CORE_TRAFFIC_STATS_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_SERIAL_HS
+#  define TRAFFIC_STATS_SIZE  256
+#  define TRAFFIC_STATS_PAGE  16
+#else
+#  define TRAFFIC_STATS_SIZE  64
+#  define TRAFFIC_STATS_PAGE  4
+#endif
+
+/* Table is kept three quarters full at most to limit probe sequences */
+#define TRAFFIC_STATS_LIMIT   (TRAFFIC_STATS_SIZE * 3 / 4)
+/* Type (1) + Identifier (8) + DLC (1) + Count, time, two gaps (8 each) + EOL */
+#define TRAFFIC_STATS_RECORD  (1 + 8 + 1 + 8 * 4 + 1)
+/* Identifier flag of extended frames */
+#define TRAFFIC_STATS_EXT     0x80000000UL
+/* Identifier of the empty entry */
+#define TRAFFIC_STATS_NONE    UINT32_MAX
+
+struct TrafficEntry
+{
+  /* Identifier, extended identifiers have the most significant bit set */
+  uint32_t id;
+  /* Number of received frames */
+  uint32_t count;
+  /* Timestamp of the last frame in timer ticks */
+  uint32_t last;
+  /* Minimal and maximal intervals between frames in timer ticks */
+  uint32_t minGap;
+  uint32_t maxGap;
+  /* Data length code of the last frame */
+  uint8_t dlc;
+};
+
+struct TrafficStats
+{
+  struct TrafficEntry entries[TRAFFIC_STATS_SIZE];
+  /* Number of tracked identifiers */
+  size_t count;
+  /* Frames of identifiers that did not fit into the table */
+  uint32_t overflows;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void trafficStatsReset(struct TrafficStats *);
+void trafficStatsUpdate(struct TrafficStats *, const struct ProxyMessage *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_TRAFFIC_STATS_H_ */
@@ -0,0 +1,53 @@
+/*
+ * core/work_profile.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "work_profile.h"
+/*----------------------------------------------------------------------------*/
+void workProfileEnqueue(struct WorkProfile *profile, enum WorkHandler handler,
+    size_t pending, bool added)
+{
+  struct HandlerProfile * const entry = profile->handlers + handler;
+
+  if (added)
+  {
+    ++entry->enqueued;
+    entry->pending += (uint32_t)pending;
+  }
+  else
+    ++entry->dropped;
+}
+/*----------------------------------------------------------------------------*/
+void workProfileReset(struct WorkProfile *profile, uint32_t now)
+{
+  for (size_t i = 0; i < ARRAY_SIZE(profile->handlers); ++i)
+  {
+    struct HandlerProfile * const entry = profile->handlers + i;
+
+    entry->total = 0;
+    entry->count = 0;
+    entry->min = UINT32_MAX;
+    entry->max = 0;
+    entry->enqueued = 0;
+    entry->pending = 0;
+    entry->dropped = 0;
+  }
+
+  profile->start = now;
+}
+/*----------------------------------------------------------------------------*/
+void workProfileRun(struct WorkProfile *profile, enum WorkHandler handler,
+    uint32_t duration)
+{
+  struct HandlerProfile * const entry = profile->handlers + handler;
+
+  ++entry->count;
+  entry->total += duration;
+
+  if (duration < entry->min)
+    entry->min = duration;
+  if (duration > entry->max)
+    entry->max = duration;
+}
@@ -0,0 +1,68 @@
+/*
+ * core/work_profile.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef CORE_WORK_PROFILE_H_
+#define CORE_WORK_PROFILE_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * Type (1) + Handler (1) + Count, minimal, average and maximal time (8 each)
+ * + Average pending handlers (4) + Drops (8) + EOL (1)
+ */
+#define WORK_PROFILE_RECORD (1 + 1 + 8 * 4 + 4 + 8 + 1)
+/* Type (1) + Busy time (4) + EOL (1) */
+#define WORK_PROFILE_TOTAL  (1 + 4 + 1)
+
+enum [[gnu::packed]] WorkHandler
+{
+  WORK_HANDLER_CAN,
+  WORK_HANDLER_SERIAL,
+  WORK_HANDLER_JOBS,
+
+  WORK_HANDLER_END
+};
+
+struct HandlerProfile
+{
+  /* Total run time in timer ticks */
+  uint64_t total;
+  /* Number of completed invocations */
+  uint32_t count;
+  /* Minimal and maximal run time in timer ticks */
+  uint32_t min;
+  uint32_t max;
+
+  /* Number of successful enqueue operations */
+  uint32_t enqueued;
+  /*
+   * Sum of pending handlers of the same port at enqueue time, handlers
+   * of other ports in the shared work queue are not counted
+   */
+  uint32_t pending;
+  /* Enqueue operations rejected by the work queue */
+  uint32_t dropped;
+};
+
+struct WorkProfile
+{
+  struct HandlerProfile handlers[WORK_HANDLER_END];
+  /* Timer value at the beginning of the measurement */
+  uint32_t start;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void workProfileEnqueue(struct WorkProfile *, enum WorkHandler, size_t, bool);
+void workProfileReset(struct WorkProfile *, uint32_t);
+void workProfileRun(struct WorkProfile *, enum WorkHandler, uint32_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* CORE_WORK_PROFILE_H_ */
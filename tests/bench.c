@@ -0,0 +1,93 @@
+/*
+ * tests/bench.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+/* Monotonic clock is a POSIX extension */
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*----------------------------------------------------------------------------*/
+static void printHeader(void);
+/*----------------------------------------------------------------------------*/
+volatile uint32_t benchSink = 0;
+/*----------------------------------------------------------------------------*/
+static void printHeader(void)
+{
+  static bool printed = false;
+
+  /* Results are printed as CSV rows with one metric per row */
+  if (!printed)
+  {
+    printf("benchmark,mix,metric,value\n");
+    printed = true;
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint64_t benchGetTime(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+/*----------------------------------------------------------------------------*/
+bool benchParseOptions(struct BenchOptions *options, int argc, char **argv,
+    size_t iterations)
+{
+  options->trace = NULL;
+  options->iterations = iterations;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc)
+    {
+      const long value = strtol(argv[++i], NULL, 10);
+
+      if (value <= 0)
+        return false;
+      options->iterations = (size_t)value;
+    }
+    else if (argv[i][0] != '-' && options->trace == NULL)
+    {
+      options->trace = argv[i];
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [-n ITERATIONS] [TRACE]\n", argv[0]);
+      return false;
+    }
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void benchReport(const char *benchmark, const char *mix, size_t items,
+    size_t bytes, uint64_t elapsed)
+{
+  printHeader();
+
+  if (!elapsed)
+    elapsed = 1;
+
+  printf("%s,%s,ns_per_item,%.3f\n", benchmark, mix,
+      (double)elapsed / (double)items);
+
+  if (bytes)
+  {
+    printf("%s,%s,bytes_per_s,%.0f\n", benchmark, mix,
+        (double)bytes * 1e9 / (double)elapsed);
+  }
+}
+/*----------------------------------------------------------------------------*/
+void benchReportValue(const char *benchmark, const char *mix,
+    const char *metric, double value)
+{
+  printHeader();
+  printf("%s,%s,%s,%.6g\n", benchmark, mix, metric, value);
+}
@@ -0,0 +1,35 @@
+/*
+ * tests/bench.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef TESTS_BENCH_H_
+#define TESTS_BENCH_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+struct BenchOptions
+{
+  /* Path to a recorded trace in the candump log format, may be NULL */
+  const char *trace;
+  /* Number of passes over each frame mix */
+  size_t iterations;
+};
+
+/* Results of benchmarked calls are accumulated here to keep the calls */
+extern volatile uint32_t benchSink;
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+uint64_t benchGetTime(void);
+bool benchParseOptions(struct BenchOptions *, int, char **, size_t);
+void benchReport(const char *, const char *, size_t, size_t, uint64_t);
+void benchReportValue(const char *, const char *, const char *, double);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* TESTS_BENCH_H_ */
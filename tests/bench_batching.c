@@ -0,0 +1,216 @@
+/*
+ * tests/bench_batching.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "batch_policy.h"
+#include "bench.h"
+#include "frame_mix.h"
+#include <stdio.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+struct Simulation
+{
+  struct BatchPolicy policy;
+
+  /* Arrival times of frames in microseconds and encoded lengths */
+  uint32_t *arrivals;
+  uint32_t *latencies;
+  const uint16_t *lengths;
+  size_t count;
+
+  /* Frames received by the controller and frames sent to the host */
+  size_t received;
+  size_t sent;
+
+  /* Serial writes and serial packets of all batches */
+  size_t writes;
+  size_t packets;
+};
+/*----------------------------------------------------------------------------*/
+static int compareLatencies(const void *, const void *);
+static void flushFrames(struct Simulation *, uint32_t);
+static void reportSimulation(struct Simulation *, const char *, uint32_t,
+    uint32_t);
+static bool runSimulation(const struct FrameMix *, const uint16_t *, size_t,
+    uint32_t, uint32_t);
+/*----------------------------------------------------------------------------*/
+/* Deadlines in microseconds, zero disables batching */
+static const uint32_t deadlines[] = {0, 250, 500, 1000, 2000, 5000};
+/* Average frame rates in frames per second */
+static const uint32_t rates[] = {500, 2000, 8000};
+/*----------------------------------------------------------------------------*/
+static int compareLatencies(const void *a, const void *b)
+{
+  const uint32_t left = *(const uint32_t *)a;
+  const uint32_t right = *(const uint32_t *)b;
+
+  return (left > right) - (left < right);
+}
+/*----------------------------------------------------------------------------*/
+static void flushFrames(struct Simulation *sim, uint32_t now)
+{
+  /* Receive queue is drained in batches of limited size like in the proxy */
+  const size_t count = MIN(sim->received - sim->sent, SERIALIZED_BATCH_FRAMES);
+  size_t length = 0;
+
+  for (size_t i = sim->sent; i < sim->sent + count; ++i)
+  {
+    sim->latencies[i] = now - sim->arrivals[i];
+    length += sim->lengths[i % sim->count];
+  }
+
+  sim->sent += count;
+  ++sim->writes;
+  sim->packets += (length + SERIAL_MTU - 1) / SERIAL_MTU;
+
+  batchPolicyUpdate(&sim->policy, length, count, sim->received - sim->sent,
+      now);
+}
+/*----------------------------------------------------------------------------*/
+static void reportSimulation(struct Simulation *sim, const char *mix,
+    uint32_t deadline, uint32_t rate)
+{
+  const double elapsed = (double)sim->arrivals[sim->received - 1] / 1e6;
+  const double frames = (double)sim->sent;
+  uint64_t sum = 0;
+  char name[48];
+
+  for (size_t i = 0; i < sim->sent; ++i)
+    sum += sim->latencies[i];
+  qsort(sim->latencies, sim->sent, sizeof(uint32_t), compareLatencies);
+
+  snprintf(name, sizeof(name), "batching_%uus_%ufps", (unsigned int)deadline,
+      (unsigned int)rate);
+
+  benchReportValue(name, mix, "mean_latency_us", (double)sum / frames);
+  benchReportValue(name, mix, "p99_latency_us",
+      (double)sim->latencies[sim->sent * 99 / 100]);
+  benchReportValue(name, mix, "max_latency_us",
+      (double)sim->latencies[sim->sent - 1]);
+  benchReportValue(name, mix, "frames_per_write",
+      frames / (double)sim->writes);
+  benchReportValue(name, mix, "writes_per_s", (double)sim->writes / elapsed);
+  benchReportValue(name, mix, "packets_per_frame",
+      (double)sim->packets / frames);
+}
+/*----------------------------------------------------------------------------*/
+static bool runSimulation(const struct FrameMix *mix, const uint16_t *lengths,
+    size_t iterations, uint32_t deadline, uint32_t rate)
+{
+  const size_t total = mix->count * iterations;
+  struct Simulation sim = {
+      .arrivals = malloc(total * sizeof(uint32_t)),
+      .latencies = malloc(total * sizeof(uint32_t)),
+      .lengths = lengths,
+      .count = mix->count
+  };
+  uint32_t seed = 1;
+  /* Chrono timer runs at 1 MHz */
+  uint32_t now = 0;
+
+  if (sim.arrivals == NULL || sim.latencies == NULL)
+  {
+    free(sim.latencies);
+    free(sim.arrivals);
+    return false;
+  }
+
+  batchPolicyDisable(&sim.policy);
+  if (deadline)
+    batchPolicyEnable(&sim.policy, deadline, SERIALIZED_FRAME_MTU, now);
+
+  while (sim.sent < total)
+  {
+    uint32_t arrival = UINT32_MAX;
+
+    if (sim.received < total)
+    {
+      /* Uniformly distributed gaps with the average of the frame period */
+      arrival = now + 1 + frameMixRandom(&seed) % (2000000 / rate);
+    }
+
+    /* One-shot job timer expires at the deadline of the oldest frame */
+    while (sim.policy.pending)
+    {
+      const uint32_t wakeup = now + batchPolicyRemaining(&sim.policy, now);
+
+      if (wakeup > arrival)
+        break;
+
+      now = wakeup;
+      if (batchPolicyCheck(&sim.policy, sim.received - sim.sent, now))
+        flushFrames(&sim, now);
+    }
+
+    if (sim.received == total)
+      continue;
+
+    /* Each received frame raises a CAN event */
+    now = arrival;
+    sim.arrivals[sim.received++] = now;
+    if (batchPolicyCheck(&sim.policy, sim.received - sim.sent, now))
+      flushFrames(&sim, now);
+  }
+
+  reportSimulation(&sim, mix->name, deadline, rate);
+
+  free(sim.latencies);
+  free(sim.arrivals);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+
+  if (!benchParseOptions(&options, argc, argv, 20))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  int result = EXIT_SUCCESS;
+
+  for (size_t i = 0; i < count && result == EXIT_SUCCESS; ++i)
+  {
+    uint16_t * const lengths = malloc(mixes[i].count * sizeof(uint16_t));
+    uint8_t record[SERIALIZED_FRAME_MTU];
+
+    if (lengths == NULL)
+    {
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    /* Frames are sent as text records with millisecond timestamps */
+    for (size_t j = 0; j < mixes[i].count; ++j)
+    {
+      lengths[j] = (uint16_t)packFrame(record, mixes[i].frames + j,
+          TIMESTAMP_16_BIT);
+    }
+
+    for (size_t d = 0; d < ARRAY_SIZE(deadlines); ++d)
+    {
+      for (size_t r = 0; r < ARRAY_SIZE(rates); ++r)
+      {
+        if (!runSimulation(&mixes[i], lengths, options.iterations,
+            deadlines[d], rates[r]))
+        {
+          result = EXIT_FAILURE;
+        }
+      }
+    }
+
+    free(lengths);
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    frameMixFree(&mixes[i]);
+
+  return result;
+}
@@ -0,0 +1,210 @@
+/*
+ * tests/bench_codec.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "helpers.h"
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+struct Stream
+{
+  char *data;
+  size_t length;
+  size_t lines;
+};
+/*----------------------------------------------------------------------------*/
+static void benchHex(size_t);
+static void benchPack(const struct FrameMix *, size_t);
+static void benchParse(const struct FrameMix *, const struct Stream *, size_t);
+static void benchUnpack(const struct FrameMix *, const struct Stream *,
+    size_t);
+static void makeStream(struct Stream *, const struct FrameMix *);
+static uint32_t parseLine(const char *, size_t);
+/*----------------------------------------------------------------------------*/
+static void benchHex(size_t iterations)
+{
+  static const size_t count = 65536;
+
+  uint64_t started = benchGetTime();
+  uint32_t sum = 0;
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t value = 0; value < count; ++value)
+      sum += binToHex4((uint16_t)(value + round));
+  }
+  benchReport("binToHex4", "all", count * iterations,
+      count * iterations * sizeof(uint32_t), benchGetTime() - started);
+
+  started = benchGetTime();
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t value = 0; value < count; ++value)
+      sum += hexToBin4(binToHex4((uint16_t)(value + round)));
+  }
+  benchReport("hexToBin4", "all", count * iterations,
+      count * iterations * sizeof(uint32_t), benchGetTime() - started);
+
+  benchSink += sum;
+}
+/*----------------------------------------------------------------------------*/
+static void benchPack(const struct FrameMix *mix, size_t iterations)
+{
+  char frame[SERIALIZED_FRAME_MTU + 2 * FRAME_DATA_MAX];
+  const uint64_t started = benchGetTime();
+  size_t bytes = 0;
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t i = 0; i < mix->count; ++i)
+    {
+      const size_t length = packFrame(frame, mix->frames + i,
+          TIMESTAMP_16_BIT);
+
+      bytes += length;
+      benchSink += (uint8_t)frame[length - 2];
+    }
+  }
+
+  benchReport("packFrame", mix->name, mix->count * iterations, bytes,
+      benchGetTime() - started);
+}
+/*----------------------------------------------------------------------------*/
+static void benchParse(const struct FrameMix *mix,
+    const struct Stream *stream, size_t iterations)
+{
+  char arena[SERIALIZED_FRAME_MTU];
+  const uint64_t started = benchGetTime();
+  uint32_t sum = 0;
+
+  /* Same steps as the text parser for input chunks of the serial MTU */
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    size_t position = 0;
+
+    for (size_t offset = 0; offset < stream->length; offset += SERIAL_MTU)
+    {
+      const char * const input = stream->data + offset;
+      const size_t count = MIN(SERIAL_MTU, stream->length - offset);
+      size_t index = 0;
+
+      while (index < count)
+      {
+        const size_t eol = index + findLineEnd(input + index, count - index);
+
+        if (eol == count)
+        {
+          memcpy(arena + position, input + index, count - index);
+          position += count - index;
+          break;
+        }
+
+        if (position > 0)
+        {
+          memcpy(arena + position, input + index, eol - index);
+          sum += parseLine(arena, position + eol - index);
+          position = 0;
+        }
+        else
+          sum += parseLine(input + index, eol - index);
+
+        index = eol + 1;
+      }
+    }
+  }
+
+  benchReport("parse", mix->name, stream->lines * iterations,
+      stream->length * iterations, benchGetTime() - started);
+  benchSink += sum;
+}
+/*----------------------------------------------------------------------------*/
+static void benchUnpack(const struct FrameMix *mix,
+    const struct Stream *stream, size_t iterations)
+{
+  const uint64_t started = benchGetTime();
+  uint32_t sum = 0;
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    const char *line = stream->data;
+
+    for (size_t i = 0; i < stream->lines; ++i)
+    {
+      size_t length = 0;
+
+      while (line[length] != '\r')
+        ++length;
+
+      sum += parseLine(line, length);
+      line += length + 1;
+    }
+  }
+
+  benchReport("unpackFrame", mix->name, stream->lines * iterations,
+      stream->length * iterations, benchGetTime() - started);
+  benchSink += sum;
+}
+/*----------------------------------------------------------------------------*/
+static void makeStream(struct Stream *stream, const struct FrameMix *mix)
+{
+  stream->data = malloc(mix->count * (SERIALIZED_FRAME_MTU
+      + 2 * FRAME_DATA_MAX));
+  stream->length = 0;
+  stream->lines = mix->count;
+
+  if (stream->data == NULL)
+    abort();
+
+  /* Host commands have the same format as received frames */
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    stream->length += packFrame(stream->data + stream->length,
+        mix->frames + i, TIMESTAMP_NONE);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t parseLine(const char *line, size_t length)
+{
+  struct ProxyMessage message;
+
+  if (!unpackFrame(line, length, &message))
+    abort();
+
+  return message.id + message.length;
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+
+  if (!benchParseOptions(&options, argc, argv, 1000))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  benchHex(MAX(options.iterations / 16, 1));
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    struct Stream stream;
+
+    makeStream(&stream, &mixes[i]);
+
+    benchPack(&mixes[i], options.iterations);
+    benchUnpack(&mixes[i], &stream, options.iterations);
+    benchParse(&mixes[i], &stream, options.iterations);
+
+    free(stream.data);
+    frameMixFree(&mixes[i]);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/*
+ * tests/bench_filter.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "id_filter.h"
+#include <halm/generic/can.h>
+#include <stdio.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+struct RuleSet
+{
+  const char *name;
+  void (*make)(struct IdFilter *, uint32_t);
+};
+/*----------------------------------------------------------------------------*/
+static void benchCompiled(const char *, const struct IdFilter *,
+    const struct FrameMix *, size_t);
+static void benchLinear(const char *, const struct IdFilter *,
+    const struct FrameMix *, size_t);
+static void makeMasks(struct IdFilter *, uint32_t);
+static void makeMixed(struct IdFilter *, uint32_t);
+static void makeRanges(struct IdFilter *, uint32_t);
+static bool matchLinear(const struct IdFilter *, uint32_t, bool);
+static void verifyFilter(const struct IdFilter *, const struct FrameMix *);
+/*----------------------------------------------------------------------------*/
+static const struct RuleSet ruleSets[] = {
+    {"ranges", makeRanges},
+    {"masks", makeMasks},
+    {"mixed", makeMixed}
+};
+/*----------------------------------------------------------------------------*/
+static void benchCompiled(const char *set, const struct IdFilter *filter,
+    const struct FrameMix *mix, size_t iterations)
+{
+  const uint64_t started = benchGetTime();
+  size_t accepted = 0;
+  char name[48];
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t i = 0; i < mix->count; ++i)
+    {
+      const struct ProxyMessage * const message = mix->frames + i;
+
+      accepted += idFilterMatch(filter, message->id,
+          (message->flags & CAN_EXT_ID) != 0);
+    }
+  }
+
+  snprintf(name, sizeof(name), "idFilterMatch_%s", set);
+  benchReport(name, mix->name, mix->count * iterations, 0,
+      benchGetTime() - started);
+  benchReportValue(name, mix->name, "accepted",
+      (double)accepted / (double)(mix->count * iterations));
+}
+/*----------------------------------------------------------------------------*/
+static void benchLinear(const char *set, const struct IdFilter *filter,
+    const struct FrameMix *mix, size_t iterations)
+{
+  const uint64_t started = benchGetTime();
+  size_t accepted = 0;
+  char name[48];
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t i = 0; i < mix->count; ++i)
+    {
+      const struct ProxyMessage * const message = mix->frames + i;
+
+      accepted += matchLinear(filter, message->id,
+          (message->flags & CAN_EXT_ID) != 0);
+    }
+  }
+
+  snprintf(name, sizeof(name), "linear_%s", set);
+  benchReport(name, mix->name, mix->count * iterations, 0,
+      benchGetTime() - started);
+  benchSink += (uint32_t)accepted;
+}
+/*----------------------------------------------------------------------------*/
+static void makeMasks(struct IdFilter *filter, uint32_t seed)
+{
+  /* Groups of 16 standard and 16 extended identifiers */
+  for (size_t i = 0; i < ID_FILTER_CAPACITY / 2; ++i)
+  {
+    idFilterAddMask(filter, false, frameMixRandom(&seed) & 0x7F0, 0x00F);
+    idFilterAddMask(filter, true, frameMixRandom(&seed) & 0x1FFFFFF0UL,
+        0x0000000FUL);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void makeMixed(struct IdFilter *filter, uint32_t seed)
+{
+  /* Identifier blocks of the cyclic mix and random narrow rules */
+  idFilterAddRange(filter, false, 0x100, 0x2FF);
+  idFilterAddRange(filter, true, 0x18FF0000UL, 0x18FF7FFFUL);
+
+  for (size_t i = 0; i < ID_FILTER_CAPACITY / 4 - 1; ++i)
+  {
+    const uint32_t low = frameMixRandom(&seed) & 0x1FFFFFFFUL;
+
+    idFilterAddRange(filter, false, i * 0x40, i * 0x40 + 7);
+    idFilterAddRange(filter, true, low, MIN(low + 0xFFFF, 0x1FFFFFFFUL));
+    idFilterAddMask(filter, false, frameMixRandom(&seed) & 0x7FF, 0x003);
+    idFilterAddMask(filter, true, frameMixRandom(&seed) & 0x1FFFFFFFUL,
+        0x000000FFUL);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void makeRanges(struct IdFilter *filter, uint32_t seed)
+{
+  for (size_t i = 0; i < ID_FILTER_CAPACITY / 2; ++i)
+  {
+    const uint32_t low = frameMixRandom(&seed) & 0x1FFFFFFFUL;
+
+    idFilterAddRange(filter, false, i * 0x80, i * 0x80 + 0x1F);
+    idFilterAddRange(filter, true, low, MIN(low + 0xFFFFF, 0x1FFFFFFFUL));
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool matchLinear(const struct IdFilter *filter, uint32_t id,
+    bool extended)
+{
+  /* Rules are checked one by one in the order they were added */
+  const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+
+  if (filter->legacy.enabled
+      && ((id ^ filter->legacy.code) & ~filter->legacy.mask & limit) == 0)
+  {
+    return true;
+  }
+
+  for (size_t i = 0; i < filter->count; ++i)
+  {
+    const struct IdFilterRule * const rule = filter->rules + i;
+
+    if (rule->extended != extended)
+      continue;
+
+    if (rule->type == ID_FILTER_RANGE)
+    {
+      if (id >= rule->first && id <= rule->second)
+        return true;
+    }
+    else if (((id ^ rule->first) & ~rule->second & limit) == 0)
+      return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+static void verifyFilter(const struct IdFilter *filter,
+    const struct FrameMix *mix)
+{
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    const struct ProxyMessage * const message = mix->frames + i;
+    const bool extended = (message->flags & CAN_EXT_ID) != 0;
+
+    if (idFilterMatch(filter, message->id, extended)
+        != matchLinear(filter, message->id, extended))
+    {
+      fprintf(stderr, "Filter mismatch for identifier %08X\n", message->id);
+      abort();
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+
+  if (!benchParseOptions(&options, argc, argv, 1000))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  struct IdFilter * const filter = malloc(sizeof(struct IdFilter));
+
+  if (filter == NULL)
+    return EXIT_FAILURE;
+
+  for (size_t set = 0; set < ARRAY_SIZE(ruleSets); ++set)
+  {
+    idFilterClear(filter);
+    ruleSets[set].make(filter, 1);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      verifyFilter(filter, &mixes[i]);
+      benchCompiled(ruleSets[set].name, filter, &mixes[i],
+          options.iterations);
+      benchLinear(ruleSets[set].name, filter, &mixes[i], options.iterations);
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    frameMixFree(&mixes[i]);
+  free(filter);
+
+  return EXIT_SUCCESS;
+}
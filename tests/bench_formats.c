@@ -0,0 +1,181 @@
+/*
+ * tests/bench_formats.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "stream_decoder.h"
+#include <halm/generic/can.h>
+#include <stdio.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+/* UART of boards without USB, 8N1 framing */
+#define UART_BYTES_PER_S    (2000000 / 10)
+/* Full-Speed USB, 19 bulk packets of 64 bytes per frame */
+#define USB_FS_BYTES_PER_S  (19 * 64 * 1000)
+/* Nominal bit rate of the bus */
+#define CAN_BITS_PER_S      1000000
+/*----------------------------------------------------------------------------*/
+static void benchDecode(const struct FrameMix *, const uint8_t *, size_t,
+    enum StreamFormat, size_t);
+static size_t benchEncode(const struct FrameMix *, uint8_t *,
+    enum StreamFormat, size_t);
+static size_t encodeFrames(struct DeltaDictionary *, const struct FrameMix *,
+    uint8_t *, enum StreamFormat);
+static void reportBus(const struct FrameMix *);
+static void reportLinks(const struct FrameMix *, enum StreamFormat, size_t,
+    size_t);
+/*----------------------------------------------------------------------------*/
+static const char * const formatNames[] = {"text", "binary", "delta"};
+/*----------------------------------------------------------------------------*/
+static void benchDecode(const struct FrameMix *mix, const uint8_t *stream,
+    size_t length, enum StreamFormat format, size_t iterations)
+{
+  struct StreamDecoder decoder;
+  const uint64_t started = benchGetTime();
+  size_t frames = 0;
+  char name[32];
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    streamDecoderInit(&decoder, format, TIMESTAMP_32_BIT, false, NULL, NULL);
+    streamDecoderPush(&decoder, stream, length);
+    frames += decoder.frames;
+  }
+
+  snprintf(name, sizeof(name), "decode_%s", formatNames[format]);
+  benchReport(name, mix->name, mix->count * iterations, length * iterations,
+      benchGetTime() - started);
+
+  if (frames != mix->count * iterations)
+    abort();
+}
+/*----------------------------------------------------------------------------*/
+static size_t benchEncode(const struct FrameMix *mix, uint8_t *stream,
+    enum StreamFormat format, size_t iterations)
+{
+  struct DeltaDictionary dictionary;
+  const uint64_t started = benchGetTime();
+  size_t length = 0;
+  char name[32];
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    resetDeltaDictionary(&dictionary);
+    length = encodeFrames(&dictionary, mix, stream, format);
+    benchSink += stream[length - 1];
+  }
+
+  snprintf(name, sizeof(name), "encode_%s", formatNames[format]);
+  benchReport(name, mix->name, mix->count * iterations, length * iterations,
+      benchGetTime() - started);
+  return length;
+}
+/*----------------------------------------------------------------------------*/
+static size_t encodeFrames(struct DeltaDictionary *dictionary,
+    const struct FrameMix *mix, uint8_t *stream, enum StreamFormat format)
+{
+  size_t length = 0;
+
+  /* All formats carry 32-bit timestamps */
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    const struct ProxyMessage * const message = mix->frames + i;
+
+    switch (format)
+    {
+      case STREAM_BINARY:
+        length += packBinaryFrame(stream + length, message, true);
+        break;
+
+      case STREAM_DELTA:
+        length += packDeltaFrames(dictionary, stream + length, message, 1,
+            TIMESTAMP_32_BIT);
+        break;
+
+      default:
+        length += packFrame(stream + length, message, TIMESTAMP_32_BIT);
+        break;
+    }
+  }
+
+  return length;
+}
+/*----------------------------------------------------------------------------*/
+static void reportBus(const struct FrameMix *mix)
+{
+  uint64_t bits = 0;
+
+  /* Data phase is counted at the nominal rate, bus capacity is a minimum */
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    const struct ProxyMessage * const message = mix->frames + i;
+
+    bits += calcFrameLength(message->flags, message->length)
+        + calcDataPhaseLength(message->flags, message->length);
+  }
+
+  benchReportValue("bus", mix->name, "frames_per_s",
+      (double)CAN_BITS_PER_S * (double)mix->count / (double)bits);
+}
+/*----------------------------------------------------------------------------*/
+static void reportLinks(const struct FrameMix *mix, enum StreamFormat format,
+    size_t length, size_t text)
+{
+  const char * const name = formatNames[format];
+  const double bytes = (double)length / (double)mix->count;
+
+  benchReportValue(name, mix->name, "bytes_per_frame", bytes);
+  benchReportValue(name, mix->name, "ratio_to_text",
+      (double)text / (double)length);
+  benchReportValue(name, mix->name, "uart_frames_per_s",
+      UART_BYTES_PER_S / bytes);
+  benchReportValue(name, mix->name, "usb_fs_frames_per_s",
+      USB_FS_BYTES_PER_S / bytes);
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+
+  if (!benchParseOptions(&options, argc, argv, 1000))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const struct FrameMix * const mix = &mixes[i];
+    uint8_t * const stream = malloc(mix->count * (SERIALIZED_FRAME_MTU
+        + DELTA_KEY_OFFSET + 2 * FRAME_DATA_MAX));
+    size_t text = 0;
+
+    if (stream == NULL)
+      return EXIT_FAILURE;
+
+    reportBus(mix);
+
+    for (size_t format = 0; format < ARRAY_SIZE(formatNames); ++format)
+    {
+      const size_t length = benchEncode(mix, stream, format,
+          options.iterations);
+
+      if (format == STREAM_TEXT)
+        text = length;
+
+      reportLinks(mix, format, length, text);
+      benchDecode(mix, stream, length, format, options.iterations);
+    }
+
+    free(stream);
+    frameMixFree(&mixes[i]);
+  }
+
+  return EXIT_SUCCESS;
+}
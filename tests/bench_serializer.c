@@ -0,0 +1,207 @@
+/*
+ * tests/bench_serializer.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "helpers.h"
+#include <halm/generic/can.h>
+#include <stdio.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+typedef size_t (*BatchPacker)(void *, const struct ProxyMessage *, size_t,
+    enum TimestampFormat);
+/*----------------------------------------------------------------------------*/
+static void benchBatches(const struct FrameMix *, uint8_t *, const char *,
+    BatchPacker, size_t, size_t);
+static void benchSingle(const struct FrameMix *, uint8_t *, size_t);
+static size_t packArithmetic(void *, const struct ProxyMessage *,
+    enum TimestampFormat);
+static size_t packArithmeticFrames(void *, const struct ProxyMessage *,
+    size_t, enum TimestampFormat);
+static void verifyArithmetic(const struct FrameMix *, uint8_t *);
+/*----------------------------------------------------------------------------*/
+static void benchBatches(const struct FrameMix *mix, uint8_t *buffer,
+    const char *packer, BatchPacker pack, size_t batch, size_t iterations)
+{
+  const size_t count = mix->count - mix->count % batch;
+
+  if (!count)
+    return;
+
+  const uint64_t started = benchGetTime();
+  size_t bytes = 0;
+  char name[32];
+
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t i = 0; i < count; i += batch)
+    {
+      const size_t length = pack(buffer, mix->frames + i, batch,
+          TIMESTAMP_16_BIT);
+
+      bytes += length;
+      benchSink += buffer[length - 2];
+    }
+  }
+
+  snprintf(name, sizeof(name), "%s_%zu", packer, batch);
+  benchReport(name, mix->name, count * iterations, bytes,
+      benchGetTime() - started);
+}
+/*----------------------------------------------------------------------------*/
+static void benchSingle(const struct FrameMix *mix, uint8_t *buffer,
+    size_t iterations)
+{
+  const uint64_t started = benchGetTime();
+  size_t bytes = 0;
+
+  /* Frames are packed one by one into a contiguous batch buffer */
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    size_t length = 0;
+
+    for (size_t i = 0; i < mix->count; ++i)
+    {
+      if (length > SERIALIZED_BATCH_SIZE - SERIALIZED_FRAME_MTU)
+        length = 0;
+
+      const size_t packed = packFrame(buffer + length, mix->frames + i,
+          TIMESTAMP_16_BIT);
+
+      length += packed;
+      bytes += packed;
+      benchSink += buffer[length - 2];
+    }
+  }
+
+  benchReport("packFrame", mix->name, mix->count * iterations, bytes,
+      benchGetTime() - started);
+}
+/*----------------------------------------------------------------------------*/
+static size_t packArithmetic(void *buffer, const struct ProxyMessage *message,
+    enum TimestampFormat format)
+{
+  /* Per-frame serializer with arithmetic conversion used as the baseline */
+  uint8_t *frame = buffer;
+  char type;
+
+  if (message->flags & CAN_FD)
+    type = (message->flags & CAN_BRS) ? 'b' : 'd';
+  else
+    type = (message->flags & CAN_RTR) ? 'r' : 't';
+
+  if (message->flags & CAN_EXT_ID)
+  {
+    *frame++ = type - ('a' - 'A');
+    inPlaceBinToHex8(frame, message->id);
+    frame += 8;
+    *frame++ = binToHex(lengthToDlc(message->length));
+  }
+  else
+  {
+    inPlaceBinToHex4(frame + 1,
+        (uint16_t)((message->id << 4) | lengthToDlc(message->length)));
+    *frame = type;
+    frame += 5;
+  }
+
+  uint8_t *eof = frame + message->length * 2;
+
+  for (size_t i = 0; i < message->length; i += 2)
+  {
+    const uint16_t pair = message->data[i + 1] | (message->data[i] << 8);
+
+    inPlaceBinToHex4(frame, pair);
+    frame += 4;
+  }
+
+  if (format == TIMESTAMP_16_BIT)
+  {
+    inPlaceBinToHex4(eof, (uint16_t)message->timestamp);
+    eof += 4;
+  }
+  else if (format == TIMESTAMP_32_BIT)
+  {
+    inPlaceBinToHex8(eof, message->timestamp);
+    eof += 8;
+  }
+
+  *eof = '\r';
+  return (eof - (uint8_t *)buffer) + 1;
+}
+/*----------------------------------------------------------------------------*/
+static size_t packArithmeticFrames(void *buffer,
+    const struct ProxyMessage *messages, size_t count,
+    enum TimestampFormat format)
+{
+  uint8_t * const frames = buffer;
+  size_t length = 0;
+
+  for (size_t i = 0; i < count; ++i)
+    length += packArithmetic(frames + length, messages + i, format);
+
+  return length;
+}
+/*----------------------------------------------------------------------------*/
+static void verifyArithmetic(const struct FrameMix *mix, uint8_t *buffer)
+{
+  uint8_t * const expected = buffer + SERIALIZED_FRAME_MTU + 2 * FRAME_DATA_MAX;
+
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    const size_t length = packArithmetic(expected, mix->frames + i,
+        TIMESTAMP_16_BIT);
+
+    if (packFrame(buffer, mix->frames + i, TIMESTAMP_16_BIT) != length
+        || memcmp(buffer, expected, length))
+    {
+      fprintf(stderr, "Serializer mismatch for frame %zu\n", i);
+      abort();
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  static const size_t batches[] = {1, 2, 16};
+
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+
+  if (!benchParseOptions(&options, argc, argv, 1000))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  /* Data fields are converted in full, the buffer has room for the tail */
+  uint8_t * const buffer = malloc(SERIALIZED_BATCH_SIZE
+      + 16 * (SERIALIZED_FRAME_MTU + 2 * FRAME_DATA_MAX));
+
+  if (buffer == NULL)
+    return EXIT_FAILURE;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    verifyArithmetic(&mixes[i], buffer);
+    benchSingle(&mixes[i], buffer, options.iterations);
+
+    for (size_t j = 0; j < ARRAY_SIZE(batches); ++j)
+    {
+      benchBatches(&mixes[i], buffer, "arithmetic", packArithmeticFrames,
+          batches[j], options.iterations);
+      benchBatches(&mixes[i], buffer, "packFrames", packFrames, batches[j],
+          options.iterations);
+    }
+
+    frameMixFree(&mixes[i]);
+  }
+
+  free(buffer);
+  return EXIT_SUCCESS;
+}
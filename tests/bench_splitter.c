@@ -0,0 +1,160 @@
+/*
+ * tests/bench_splitter.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "helpers.h"
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+struct Stream
+{
+  const char *name;
+  char *data;
+  size_t length;
+  size_t lines;
+};
+
+typedef size_t (*LineSplitter)(const void *, size_t);
+/*----------------------------------------------------------------------------*/
+static size_t benchSplitter(const char *, const struct Stream *, LineSplitter,
+    size_t);
+static size_t findLineEndScalar(const void *, size_t);
+static void makeCommandStream(struct Stream *, size_t);
+static void makeFrameStream(struct Stream *, const struct FrameMix *);
+static void runStream(const struct Stream *, size_t);
+/*----------------------------------------------------------------------------*/
+static size_t benchSplitter(const char *name, const struct Stream *stream,
+    LineSplitter splitter, size_t iterations)
+{
+  const uint64_t started = benchGetTime();
+  size_t lines = 0;
+
+  /* Input is split into chunks of the serial MTU as in the proxy */
+  for (size_t round = 0; round < iterations; ++round)
+  {
+    for (size_t offset = 0; offset < stream->length; offset += SERIAL_MTU)
+    {
+      const char * const input = stream->data + offset;
+      const size_t count = MIN(SERIAL_MTU, stream->length - offset);
+      size_t index = 0;
+
+      while (index < count)
+      {
+        const size_t eol = index + splitter(input + index, count - index);
+
+        if (eol == count)
+          break;
+
+        ++lines;
+        index = eol + 1;
+      }
+    }
+  }
+
+  benchReport(name, stream->name, stream->lines * iterations,
+      stream->length * iterations, benchGetTime() - started);
+  return lines;
+}
+/*----------------------------------------------------------------------------*/
+static size_t findLineEndScalar(const void *buffer, size_t length)
+{
+  const uint8_t * const input = buffer;
+  size_t index = 0;
+
+  for (; index < length; ++index)
+  {
+    if (input[index] == '\r' || input[index] == '\n')
+      break;
+  }
+
+  return index;
+}
+/*----------------------------------------------------------------------------*/
+static void makeCommandStream(struct Stream *stream, size_t count)
+{
+  static const char * const commands[] = {
+      "F\r", "O\r", "C\r", "S6\r", "V\r", "Z1\r", "N\r", "\r"
+  };
+
+  stream->name = "commands";
+  stream->data = malloc(count * 4);
+  stream->length = 0;
+  stream->lines = count;
+
+  if (stream->data == NULL)
+    abort();
+
+  /* Short control commands without frames */
+  for (size_t i = 0; i < count; ++i)
+  {
+    const char * const command = commands[i % ARRAY_SIZE(commands)];
+    const size_t length = strlen(command);
+
+    memcpy(stream->data + stream->length, command, length);
+    stream->length += length;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void makeFrameStream(struct Stream *stream, const struct FrameMix *mix)
+{
+  stream->name = mix->name;
+  stream->data = malloc(mix->count * (SERIALIZED_FRAME_MTU
+      + 2 * FRAME_DATA_MAX));
+  stream->length = 0;
+  stream->lines = mix->count;
+
+  if (stream->data == NULL)
+    abort();
+
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    stream->length += packFrame(stream->data + stream->length,
+        mix->frames + i, TIMESTAMP_NONE);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void runStream(const struct Stream *stream, size_t iterations)
+{
+  const size_t words = benchSplitter("findLineEnd", stream, findLineEnd,
+      iterations);
+  const size_t bytes = benchSplitter("findLineEndScalar", stream,
+      findLineEndScalar, iterations);
+
+  /* Lines split across chunks are not counted, both results should match */
+  if (words != bytes)
+    abort();
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  struct BenchOptions options;
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+  struct Stream stream;
+
+  if (!benchParseOptions(&options, argc, argv, 1000))
+    return EXIT_FAILURE;
+
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, options.trace);
+
+  if (!count)
+    return EXIT_FAILURE;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    makeFrameStream(&stream, &mixes[i]);
+    runStream(&stream, options.iterations);
+
+    free(stream.data);
+    frameMixFree(&mixes[i]);
+  }
+
+  makeCommandStream(&stream, FRAME_MIX_SIZE);
+  runStream(&stream, options.iterations);
+  free(stream.data);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,317 @@
+/*
+ * tests/frame_mix.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "frame_mix.h"
+#include "helpers.h"
+#include <halm/generic/can.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+#define CYCLIC_SOURCES 32
+
+struct GroupSettings
+{
+  uint8_t flags;
+  uint8_t length;
+};
+/*----------------------------------------------------------------------------*/
+static void allocateFrames(struct FrameMix *, const char *, size_t);
+static bool parseTraceLine(const char *, struct ProxyMessage *);
+/*----------------------------------------------------------------------------*/
+/* Frame groups of the test message sequence of the proxy */
+static const struct GroupSettings testGroupSettings[] = {
+    {0, 0},
+    {0, 8},
+    {CAN_EXT_ID, 0},
+    {CAN_EXT_ID, 8},
+    {CAN_RTR, 0},
+    {CAN_RTR | CAN_EXT_ID, 0},
+#ifdef CONFIG_CAN_FD
+    {CAN_FD, 64},
+    {CAN_FD | CAN_EXT_ID, 64},
+    {CAN_FD | CAN_BRS, 64},
+    {CAN_FD | CAN_BRS | CAN_EXT_ID, 64}
+#endif
+};
+/*----------------------------------------------------------------------------*/
+static void allocateFrames(struct FrameMix *mix, const char *name,
+    size_t count)
+{
+  mix->name = name;
+  mix->frames = calloc(count ? count : 1, sizeof(struct ProxyMessage));
+  mix->count = count;
+
+  if (mix->frames == NULL)
+    abort();
+}
+/*----------------------------------------------------------------------------*/
+static bool parseTraceLine(const char *line, struct ProxyMessage *message)
+{
+  double seconds;
+  char frame[256];
+
+  /* Format of candump logs: (seconds) interface id#data */
+  if (sscanf(line, " (%lf) %*s %255s", &seconds, frame) != 2)
+    return false;
+
+  const char * const separator = strchr(frame, '#');
+
+  if (separator == NULL)
+    return false;
+
+  const size_t digits = (size_t)(separator - frame);
+  const char *position = separator + 1;
+
+  if (!digits || digits > 8)
+    return false;
+
+  memset(message, 0, sizeof(*message));
+  message->timestamp = (uint32_t)(uint64_t)(seconds * 1e6);
+  message->id = (uint32_t)strtoul(frame, NULL, 16);
+  message->flags = digits > 3 ? CAN_EXT_ID : 0;
+
+  if (*position == 'R')
+  {
+    message->flags |= CAN_RTR;
+    if (position[1] >= '0' && position[1] <= '8')
+      message->length = (uint8_t)(position[1] - '0');
+    return true;
+  }
+
+  if (*position == '#')
+  {
+#ifdef CONFIG_CAN_FD
+    /* Flags of CAN FD frames, bit 0 is the bit rate switch */
+    message->flags |= CAN_FD;
+    if (hexToBin((uint8_t)position[1]) & 0x01)
+      message->flags |= CAN_BRS;
+    position += 2;
+#else
+    return false;
+#endif
+  }
+
+  const size_t length = strlen(position) / 2;
+
+  if (length > FRAME_DATA_MAX)
+    return false;
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    message->data[i] = (uint8_t)((hexToBin((uint8_t)position[i * 2]) << 4)
+        | hexToBin((uint8_t)position[i * 2 + 1]));
+  }
+
+  message->length = (uint8_t)length;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void frameMixFree(struct FrameMix *mix)
+{
+  free(mix->frames);
+  mix->frames = NULL;
+  mix->count = 0;
+}
+/*----------------------------------------------------------------------------*/
+bool frameMixLoadTrace(struct FrameMix *mix, const char *path)
+{
+  size_t capacity = FRAME_MIX_SIZE;
+
+  /* Frames are allocated first, the mix is freed by the caller on errors */
+  allocateFrames(mix, "trace", capacity);
+  mix->count = 0;
+
+  FILE * const stream = fopen(path, "r");
+
+  if (stream == NULL)
+    return false;
+
+  char line[512];
+  size_t count = 0;
+
+  while (fgets(line, sizeof(line), stream) != NULL)
+  {
+    if (count == capacity)
+    {
+      capacity *= 2;
+      mix->frames = realloc(mix->frames,
+          capacity * sizeof(struct ProxyMessage));
+
+      if (mix->frames == NULL)
+        abort();
+    }
+
+    /* Lines with unsupported frames are skipped */
+    if (parseTraceLine(line, mix->frames + count))
+      ++count;
+  }
+
+  fclose(stream);
+  mix->count = count;
+
+  return count > 0;
+}
+/*----------------------------------------------------------------------------*/
+size_t frameMixMakeAll(struct FrameMix *mixes, size_t count,
+    const char *trace)
+{
+  frameMixMakeTest(&mixes[0], count);
+  frameMixMakeRandom(&mixes[1], count, 1);
+  frameMixMakeCyclic(&mixes[2], count, 1);
+
+  if (trace == NULL)
+    return 3;
+
+  if (!frameMixLoadTrace(&mixes[3], trace))
+  {
+    fprintf(stderr, "Failed to load trace %s\n", trace);
+    frameMixFree(&mixes[3]);
+
+    for (size_t i = 0; i < 3; ++i)
+      frameMixFree(&mixes[i]);
+    return 0;
+  }
+
+  return 4;
+}
+/*----------------------------------------------------------------------------*/
+void frameMixMakeCyclic(struct FrameMix *mix, size_t count, uint32_t seed)
+{
+  static const uint16_t periods[] = {10, 20, 50, 100, 200, 500, 1000};
+
+  struct
+  {
+    struct ProxyMessage message;
+    uint16_t period;
+    uint16_t phase;
+  } sources[CYCLIC_SOURCES];
+  size_t index = 0;
+
+  allocateFrames(mix, "cyclic", count);
+
+  /* Periodic sources with fixed identifiers and mostly constant payloads */
+  for (size_t i = 0; i < ARRAY_SIZE(sources); ++i)
+  {
+    struct ProxyMessage * const message = &sources[i].message;
+
+    memset(message, 0, sizeof(*message));
+    message->flags = (i % 4 == 3) ? CAN_EXT_ID : 0;
+    message->id = (message->flags & CAN_EXT_ID) ?
+        0x18FF0000UL + (frameMixRandom(&seed) & 0xFFFF) :
+        0x100 + (uint32_t)i * 0x10;
+    message->length = (i % 8 == 7) ? 4 : 8;
+
+    for (size_t j = 0; j < message->length; ++j)
+      message->data[j] = (uint8_t)frameMixRandom(&seed);
+
+    sources[i].period = periods[i % ARRAY_SIZE(periods)];
+    sources[i].phase = (uint16_t)(frameMixRandom(&seed)
+        % sources[i].period);
+  }
+
+  for (uint32_t time = 0; index < count; ++time)
+  {
+    for (size_t i = 0; i < ARRAY_SIZE(sources) && index < count; ++i)
+    {
+      if (time % sources[i].period != sources[i].phase)
+        continue;
+
+      struct ProxyMessage * const message = &sources[i].message;
+
+      /* Rolling counter and an occasionally changed signal */
+      ++message->data[0];
+      if (!(frameMixRandom(&seed) & 3))
+      {
+        const size_t position = 1 + frameMixRandom(&seed)
+            % (message->length - 1);
+        message->data[position] = (uint8_t)frameMixRandom(&seed);
+      }
+
+      message->timestamp = time * 1000;
+      mix->frames[index++] = *message;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+void frameMixMakeRandom(struct FrameMix *mix, size_t count, uint32_t seed)
+{
+  uint32_t timestamp = 0;
+
+  allocateFrames(mix, "random", count);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    struct ProxyMessage * const message = mix->frames + i;
+    const uint32_t value = frameMixRandom(&seed);
+
+    message->flags = (value & 1) ? CAN_EXT_ID : 0;
+    message->id = frameMixRandom(&seed)
+        & ((message->flags & CAN_EXT_ID) ? 0x1FFFFFFFUL : 0x7FFUL);
+
+#ifdef CONFIG_CAN_FD
+    if (!(value & 0x0C))
+    {
+      message->flags |= CAN_FD;
+      if (value & 0x10)
+        message->flags |= CAN_BRS;
+      message->length = dlcToLength((uint8_t)(value >> 8));
+    }
+    else
+#endif
+    if (!(value & 0x0E))
+    {
+      message->flags |= CAN_RTR;
+      message->length = (uint8_t)((value >> 8) % 9);
+    }
+    else
+      message->length = (uint8_t)((value >> 8) % 9);
+
+    if (!(message->flags & CAN_RTR))
+    {
+      for (size_t j = 0; j < message->length; ++j)
+        message->data[j] = (uint8_t)frameMixRandom(&seed);
+    }
+
+    timestamp += 100 + (value >> 24);
+    message->timestamp = timestamp;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void frameMixMakeTest(struct FrameMix *mix, size_t count)
+{
+  static const size_t groups = ARRAY_SIZE(testGroupSettings);
+
+  allocateFrames(mix, "test", count);
+
+  /* Groups of the test sequence are interleaved */
+  for (size_t i = 0; i < count; ++i)
+  {
+    struct ProxyMessage * const message = mix->frames + i;
+    const struct GroupSettings * const group = testGroupSettings + i % groups;
+
+    message->timestamp = (uint32_t)i * 100;
+    message->id = (uint32_t)(i / groups);
+    message->flags = group->flags;
+    message->length = group->length;
+
+    for (size_t j = 0; j < ARRAY_SIZE(message->data); ++j)
+      message->data[j] = (uint8_t)(j + 1);
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint32_t frameMixRandom(uint32_t *state)
+{
+  /* Xorshift generator gives the same sequence on every host */
+  uint32_t value = *state;
+
+  value ^= value << 13;
+  value ^= value >> 17;
+  value ^= value << 5;
+
+  *state = value;
+  return value;
+}
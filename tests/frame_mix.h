@@ -0,0 +1,37 @@
+/*
+ * tests/frame_mix.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef TESTS_FRAME_MIX_H_
+#define TESTS_FRAME_MIX_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+#include <stdbool.h>
+/*----------------------------------------------------------------------------*/
+/* Default number of frames in synthetic mixes */
+#define FRAME_MIX_SIZE  1024
+/* Synthetic mixes and an optional recorded trace */
+#define FRAME_MIX_COUNT 4
+
+struct FrameMix
+{
+  const char *name;
+  struct ProxyMessage *frames;
+  size_t count;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void frameMixFree(struct FrameMix *);
+bool frameMixLoadTrace(struct FrameMix *, const char *);
+size_t frameMixMakeAll(struct FrameMix *, size_t, const char *);
+void frameMixMakeCyclic(struct FrameMix *, size_t, uint32_t);
+void frameMixMakeRandom(struct FrameMix *, size_t, uint32_t);
+void frameMixMakeTest(struct FrameMix *, size_t);
+uint32_t frameMixRandom(uint32_t *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* TESTS_FRAME_MIX_H_ */
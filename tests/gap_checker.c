@@ -0,0 +1,55 @@
+/*
+ * tests/gap_checker.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "gap_checker.h"
+/*----------------------------------------------------------------------------*/
+void gapCheckerInit(struct GapChecker *checker)
+{
+  checker->timestamp = 0;
+  checker->sequence = 0;
+  checker->started = false;
+
+  checker->frames = 0;
+  checker->gaps = 0;
+  checker->missing = 0;
+  checker->repeated = 0;
+}
+/*----------------------------------------------------------------------------*/
+bool gapCheckerPush(struct GapChecker *checker, uint16_t sequence,
+    uint32_t timestamp, struct SequenceGap *gap)
+{
+  /* Numbers are compared modulo 65536, longer losses are not visible */
+  const uint16_t difference = (uint16_t)(sequence - checker->sequence);
+  const bool started = checker->started;
+  const uint32_t previous = checker->timestamp;
+
+  ++checker->frames;
+  checker->sequence = sequence;
+  checker->timestamp = timestamp;
+  checker->started = true;
+
+  if (!started || difference == 1)
+    return false;
+
+  if (!difference)
+  {
+    ++checker->repeated;
+    return false;
+  }
+
+  ++checker->gaps;
+  checker->missing += (size_t)difference - 1;
+
+  if (gap != NULL)
+  {
+    gap->before = previous;
+    gap->after = timestamp;
+    gap->first = (uint16_t)(sequence - difference + 1);
+    gap->count = (uint16_t)(difference - 1);
+  }
+
+  return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * tests/gap_checker.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef TESTS_GAP_CHECKER_H_
+#define TESTS_GAP_CHECKER_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+/* Frames missing between two consecutive received frames */
+struct SequenceGap
+{
+  /* Timestamps of the frames before and after the gap */
+  uint32_t before;
+  uint32_t after;
+
+  /* First missing sequence number and number of missing frames */
+  uint16_t first;
+  uint16_t count;
+};
+
+/* Host side checker of sequence numbers appended by the n1 command */
+struct GapChecker
+{
+  /* Sequence number and timestamp of the previous frame */
+  uint32_t timestamp;
+  uint16_t sequence;
+  bool started;
+
+  /* Checked frames, found gaps and frames lost in them */
+  size_t frames;
+  size_t gaps;
+  size_t missing;
+  /* Frames with the same number as the previous frame */
+  size_t repeated;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void gapCheckerInit(struct GapChecker *);
+bool gapCheckerPush(struct GapChecker *, uint16_t, uint32_t,
+    struct SequenceGap *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* TESTS_GAP_CHECKER_H_ */
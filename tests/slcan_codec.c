@@ -0,0 +1,278 @@
+/*
+ * tests/slcan_codec.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "frame_mix.h"
+#include "gap_checker.h"
+#include "stream_decoder.h"
+#include <halm/generic/can.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+struct CheckContext
+{
+  struct GapChecker checker;
+  enum TimestampFormat timestamps;
+
+  /* Frames without sequence numbers */
+  size_t unnumbered;
+};
+/*----------------------------------------------------------------------------*/
+static void checkFrame(void *, const struct ProxyMessage *, const uint16_t *);
+static int checkStream(FILE *, enum StreamFormat, enum TimestampFormat);
+static int decodeStream(FILE *, enum StreamFormat, enum TimestampFormat, bool);
+static int encodeTrace(const char *, enum StreamFormat, enum TimestampFormat,
+    bool);
+static void printFrame(void *, const struct ProxyMessage *, const uint16_t *);
+static void printTimestamp(uint32_t, enum TimestampFormat);
+static void printUsage(const char *);
+/*----------------------------------------------------------------------------*/
+static void checkFrame(void *argument, const struct ProxyMessage *message,
+    const uint16_t *sequence)
+{
+  struct CheckContext * const context = argument;
+  struct SequenceGap gap;
+
+  if (sequence == NULL)
+  {
+    ++context->unnumbered;
+    return;
+  }
+
+  if (gapCheckerPush(&context->checker, *sequence, message->timestamp, &gap))
+  {
+    printf("%u frames lost from %04X between ", (unsigned int)gap.count,
+        (unsigned int)gap.first);
+    printTimestamp(gap.before, context->timestamps);
+    printf(" and ");
+    printTimestamp(gap.after, context->timestamps);
+    printf("\n");
+  }
+}
+/*----------------------------------------------------------------------------*/
+static int checkStream(FILE *input, enum StreamFormat format,
+    enum TimestampFormat timestamps)
+{
+  struct CheckContext context = {
+      .timestamps = timestamps,
+      .unnumbered = 0
+  };
+  struct StreamDecoder decoder;
+  uint8_t buffer[SERIAL_MTU];
+  size_t count;
+
+  gapCheckerInit(&context.checker);
+  streamDecoderInit(&decoder, format, timestamps, true, checkFrame, &context);
+
+  while ((count = fread(buffer, 1, sizeof(buffer), input)) > 0)
+    streamDecoderPush(&decoder, buffer, count);
+
+  fprintf(stderr, "%zu frames, %zu gaps, %zu lost, %zu repeated, "
+      "%zu unnumbered, %zu errors\n", decoder.frames, context.checker.gaps,
+      context.checker.missing, context.checker.repeated, context.unnumbered,
+      decoder.errors);
+
+  return decoder.errors || context.checker.gaps || context.unnumbered ?
+      EXIT_FAILURE : EXIT_SUCCESS;
+}
+/*----------------------------------------------------------------------------*/
+static int decodeStream(FILE *input, enum StreamFormat format,
+    enum TimestampFormat timestamps, bool sequences)
+{
+  struct StreamDecoder decoder;
+  uint8_t buffer[SERIAL_MTU];
+  size_t count;
+
+  streamDecoderInit(&decoder, format, timestamps, sequences, printFrame,
+      &timestamps);
+
+  while ((count = fread(buffer, 1, sizeof(buffer), input)) > 0)
+    streamDecoderPush(&decoder, buffer, count);
+
+  fprintf(stderr, "%zu frames, %zu errors\n", decoder.frames,
+      decoder.errors);
+  return decoder.errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+/*----------------------------------------------------------------------------*/
+static int encodeTrace(const char *path, enum StreamFormat format,
+    enum TimestampFormat timestamps, bool sequences)
+{
+  struct DeltaDictionary dictionary;
+  struct FrameMix trace;
+
+  if (!frameMixLoadTrace(&trace, path))
+  {
+    fprintf(stderr, "Failed to load trace %s\n", path);
+    frameMixFree(&trace);
+    return EXIT_FAILURE;
+  }
+
+  resetDeltaDictionary(&dictionary);
+
+  for (size_t i = 0; i < trace.count; ++i)
+  {
+    uint8_t record[SERIALIZED_FRAME_MTU + DELTA_KEY_OFFSET
+        + 2 * FRAME_DATA_MAX + SEQ_TEXT_LENGTH];
+    struct ProxyMessage message = trace.frames[i];
+    size_t length;
+
+    /* Timestamps of the trace are converted like on the device */
+    if (timestamps == TIMESTAMP_16_BIT)
+      message.timestamp = (message.timestamp / 1000) % 60000;
+
+    switch (format)
+    {
+      case STREAM_BINARY:
+        length = packBinaryFrame(record, &message,
+            timestamps != TIMESTAMP_NONE);
+        break;
+
+      case STREAM_DELTA:
+        length = packDeltaFrames(&dictionary, record, &message, 1,
+            timestamps);
+        break;
+
+      default:
+        length = packFrame(record, &message, timestamps);
+        break;
+    }
+
+    /* Frames of the trace are numbered like after the n1 command */
+    if (sequences)
+    {
+      length = packSequence(record, length, (uint16_t)i,
+          format == STREAM_BINARY);
+    }
+
+    fwrite(record, 1, length, stdout);
+  }
+
+  frameMixFree(&trace);
+  return EXIT_SUCCESS;
+}
+/*----------------------------------------------------------------------------*/
+static void printFrame(void *argument, const struct ProxyMessage *message,
+    const uint16_t *)
+{
+  const enum TimestampFormat * const timestamps = argument;
+
+  printTimestamp(message->timestamp, *timestamps);
+  printf(" slcan0 ");
+
+  if (message->flags & CAN_EXT_ID)
+    printf("%08X", message->id);
+  else
+    printf("%03X", message->id);
+
+  if (message->flags & CAN_FD)
+    printf("##%u", (message->flags & CAN_BRS) ? 1 : 0);
+  else if (message->flags & CAN_RTR)
+    printf("#R");
+  else
+    printf("#");
+
+  if (!(message->flags & CAN_RTR))
+  {
+    for (size_t i = 0; i < message->length; ++i)
+      printf("%02X", message->data[i]);
+  }
+
+  printf("\n");
+}
+/*----------------------------------------------------------------------------*/
+static void printTimestamp(uint32_t timestamp, enum TimestampFormat format)
+{
+  const uint32_t divisor = format == TIMESTAMP_16_BIT ? 1000 : 1000000;
+  const uint32_t scale = 1000000 / divisor;
+
+  printf("(%010u.%06u)", timestamp / divisor, timestamp % divisor * scale);
+}
+/*----------------------------------------------------------------------------*/
+static void printUsage(const char *name)
+{
+  fprintf(stderr,
+      "Usage: %s encode|decode|check [-b|-d] [-s] [-z FORMAT] [FILE]\n"
+      "  encode  convert a candump log to frame records of the proxy\n"
+      "  decode  convert frame records of the proxy to a candump log\n"
+      "  check   report gaps in sequence numbers of frame records\n"
+      "  -b      binary records instead of text records\n"
+      "  -d      delta records instead of text records\n"
+      "  -s      records with sequence numbers as after the n1 command\n"
+      "  -z      timestamp format as in the Z command: 0, 1 or 2\n", name);
+}
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  enum TimestampFormat timestamps = TIMESTAMP_NONE;
+  const char *path = NULL;
+  enum StreamFormat format = STREAM_TEXT;
+  bool sequences = false;
+
+  if (argc < 2 || (strcmp(argv[1], "encode") && strcmp(argv[1], "decode")
+      && strcmp(argv[1], "check")))
+  {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 2; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "-b"))
+    {
+      format = STREAM_BINARY;
+    }
+    else if (!strcmp(argv[i], "-d"))
+    {
+      format = STREAM_DELTA;
+    }
+    else if (!strcmp(argv[i], "-s"))
+    {
+      sequences = true;
+    }
+    else if (!strcmp(argv[i], "-z") && i + 1 < argc)
+    {
+      const long value = strtol(argv[++i], NULL, 10);
+
+      if (value < TIMESTAMP_NONE || value > TIMESTAMP_32_BIT)
+      {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      timestamps = (enum TimestampFormat)value;
+    }
+    else if (argv[i][0] != '-' && path == NULL)
+    {
+      path = argv[i];
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!strcmp(argv[1], "encode"))
+  {
+    return encodeTrace(path != NULL ? path : "/dev/stdin", format, timestamps,
+        sequences);
+  }
+
+  FILE * const input = path != NULL ? fopen(path, "rb") : stdin;
+
+  if (input == NULL)
+  {
+    fprintf(stderr, "Failed to open %s\n", path);
+    return EXIT_FAILURE;
+  }
+
+  /* Sequence numbers are always expected by the checker */
+  const int result = !strcmp(argv[1], "check") ?
+      checkStream(input, format, timestamps) :
+      decodeStream(input, format, timestamps, sequences);
+
+  if (input != stdin)
+    fclose(input);
+  return result;
+}
@@ -0,0 +1,391 @@
+/*
+ * tests/stream_decoder.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "stream_decoder.h"
+#include "helpers.h"
+#include <halm/generic/can.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static void decodeBinary(struct StreamDecoder *, const uint8_t *, size_t);
+static void decodeDelta(struct StreamDecoder *, const uint8_t *, size_t,
+    const uint16_t *);
+static bool decodeFrame(struct StreamDecoder *, const uint8_t *, size_t,
+    struct ProxyMessage *);
+static void decodeKeyframe(struct StreamDecoder *, const uint8_t *, size_t,
+    const uint16_t *);
+static void decodeLine(struct StreamDecoder *, const uint8_t *, size_t);
+static void decodeText(struct StreamDecoder *, const uint8_t *, size_t);
+static size_t getTimestampLength(enum TimestampFormat);
+static bool hasBinaryDrops(const uint8_t *);
+static bool hasBinarySequence(const uint8_t *);
+static bool isFrameType(uint8_t);
+static void pushFrame(struct StreamDecoder *, const struct ProxyMessage *,
+    const uint16_t *);
+static uint8_t unpackByte(const uint8_t *);
+static uint32_t unpackTimestamp(const uint8_t *, enum TimestampFormat);
+/*----------------------------------------------------------------------------*/
+static void decodeBinary(struct StreamDecoder *decoder, const uint8_t *input,
+    size_t count)
+{
+  for (size_t index = 0; index < count; ++index)
+  {
+    /* Text responses between binary records are skipped */
+    if (!decoder->position && input[index] != BIN_FRAME_MARKER)
+      continue;
+
+    decoder->arena[decoder->position++] = input[index];
+    if (decoder->position < 2)
+      continue;
+
+    size_t length = getBinaryFrameLength(decoder->arena[1]);
+
+    if (!length)
+    {
+      ++decoder->errors;
+      decoder->position = 0;
+      continue;
+    }
+
+    /* Flag of the sequence field is known after the identifier */
+    const bool sequenced = decoder->position >= BIN_DATA_OFFSET
+        && hasBinarySequence(decoder->arena);
+
+    if (sequenced)
+      length += SEQ_BIN_LENGTH;
+
+    if (decoder->position == length)
+    {
+      struct ProxyMessage message;
+      uint16_t sequence = 0;
+
+      if (sequenced)
+      {
+        uint16_t word;
+
+        length -= SEQ_BIN_LENGTH;
+        memcpy(&word, decoder->arena + length, sizeof(word));
+        sequence = fromLittleEndian16(word);
+
+        /* Flag is cleared to unpack the identifier */
+        decoder->arena[BIN_DATA_OFFSET - 1] &= 0x7F;
+      }
+
+      if (hasBinaryDrops(decoder->arena))
+      {
+        uint32_t counters[2];
+
+        if (!sequenced && unpackBinaryDrops(decoder->arena, length, counters))
+        {
+          decoder->dropped[0] += counters[0];
+          decoder->dropped[1] += counters[1];
+        }
+        else
+          ++decoder->errors;
+      }
+      else if (unpackBinaryFrame(decoder->arena, length, &message))
+        pushFrame(decoder, &message, sequenced ? &sequence : NULL);
+      else
+        ++decoder->errors;
+
+      decoder->position = 0;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void decodeDelta(struct StreamDecoder *decoder, const uint8_t *line,
+    size_t length, const uint16_t *sequence)
+{
+  const size_t timestamp = getTimestampLength(decoder->timestamps);
+
+  if (length < DELTA_KEY_OFFSET + 2 + timestamp)
+  {
+    ++decoder->errors;
+    return;
+  }
+
+  const size_t index = unpackByte(line + 1);
+  const uint8_t mask = unpackByte(line + DELTA_KEY_OFFSET);
+  const size_t changes = (size_t)__builtin_popcount(mask);
+
+  if (index >= ARRAY_SIZE(decoder->dictionary.entries)
+      || DELTA_KEY_OFFSET + 2 + changes * 2 + timestamp != length)
+  {
+    ++decoder->errors;
+    return;
+  }
+
+  struct DeltaEntry * const entry = decoder->dictionary.entries + index;
+
+  /* Empty entries and bytes outside of the data field are rejected */
+  if (entry->length > ARRAY_SIZE(entry->data) || (mask >> entry->length))
+  {
+    ++decoder->errors;
+    return;
+  }
+
+  struct ProxyMessage message;
+  const uint8_t *position = line + DELTA_KEY_OFFSET + 2;
+
+  for (size_t i = 0; i < entry->length; ++i)
+  {
+    if (mask & (1 << i))
+    {
+      entry->data[i] = unpackByte(position);
+      position += 2;
+    }
+  }
+
+  memset(&message, 0, sizeof(message));
+  message.id = entry->id;
+  message.flags = entry->flags;
+  message.length = entry->length;
+  memcpy(message.data, entry->data, entry->length);
+  message.timestamp = unpackTimestamp(position, decoder->timestamps);
+
+  pushFrame(decoder, &message, sequence);
+}
+/*----------------------------------------------------------------------------*/
+static bool decodeFrame(struct StreamDecoder *decoder, const uint8_t *line,
+    size_t length, struct ProxyMessage *message)
+{
+  const size_t timestamp = getTimestampLength(decoder->timestamps);
+
+  memset(message, 0, sizeof(*message));
+
+  if (!length || !isFrameType(line[0]))
+    return false;
+  if (length < timestamp || !unpackFrame(line, length - timestamp, message))
+    return false;
+
+  const size_t offset = (message->flags & CAN_EXT_ID) ?
+      EXT_DATA_OFFSET : STD_DATA_OFFSET;
+  size_t data = message->length * 2;
+
+  /* Remote frames are sent with the data field of the received message */
+  if ((message->flags & CAN_RTR) && offset + timestamp == length)
+    data = 0;
+
+  /* Trailing characters are accepted by the parser of the proxy only */
+  if (offset + data + timestamp != length)
+    return false;
+
+  message->timestamp = unpackTimestamp(line + offset + data,
+      decoder->timestamps);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void decodeKeyframe(struct StreamDecoder *decoder, const uint8_t *line,
+    size_t length, const uint16_t *sequence)
+{
+  struct ProxyMessage message;
+
+  if (length < DELTA_KEY_OFFSET
+      || !decodeFrame(decoder, line + DELTA_KEY_OFFSET,
+          length - DELTA_KEY_OFFSET, &message))
+  {
+    ++decoder->errors;
+    return;
+  }
+
+  const size_t index = unpackByte(line + 1);
+
+  if (index >= ARRAY_SIZE(decoder->dictionary.entries)
+      || message.length > ARRAY_SIZE(decoder->dictionary.entries[0].data))
+  {
+    ++decoder->errors;
+    return;
+  }
+
+  /* Keyframe replaces the dictionary entry */
+  struct DeltaEntry * const entry = decoder->dictionary.entries + index;
+
+  entry->id = message.id;
+  entry->flags = message.flags;
+  entry->length = message.length;
+  memcpy(entry->data, message.data, message.length);
+
+  pushFrame(decoder, &message, sequence);
+}
+/*----------------------------------------------------------------------------*/
+static void decodeLine(struct StreamDecoder *decoder, const uint8_t *line,
+    size_t length)
+{
+  struct ProxyMessage message;
+  uint16_t sequence = 0;
+
+  if (!length)
+    return;
+
+  const bool delta = decoder->format == STREAM_DELTA
+      && (line[0] == 'k' || line[0] == 'x');
+
+  /* Responses to commands are not frames and are skipped */
+  if (!delta && !isFrameType(line[0]))
+    return;
+
+  /* Sequence number is the last field of the record */
+  if (decoder->sequences)
+  {
+    if (length <= SEQ_TEXT_LENGTH
+        || line[length - SEQ_TEXT_LENGTH] != SEQ_TEXT_SEPARATOR)
+    {
+      ++decoder->errors;
+      return;
+    }
+
+    length -= SEQ_TEXT_LENGTH;
+    sequence = inPlaceHexToBin4(line + length + 1);
+  }
+
+  const uint16_t * const number = decoder->sequences ? &sequence : NULL;
+
+  if (delta)
+  {
+    if (line[0] == 'k')
+      decodeKeyframe(decoder, line, length, number);
+    else
+      decodeDelta(decoder, line, length, number);
+  }
+  else if (decodeFrame(decoder, line, length, &message))
+    pushFrame(decoder, &message, number);
+  else
+    ++decoder->errors;
+}
+/*----------------------------------------------------------------------------*/
+static void decodeText(struct StreamDecoder *decoder, const uint8_t *input,
+    size_t count)
+{
+  for (size_t index = 0; index < count; ++index)
+  {
+    const uint8_t value = input[index];
+
+    if (value == '\r' || value == '\a')
+    {
+      if (!decoder->skip)
+        decodeLine(decoder, decoder->arena, decoder->position);
+
+      decoder->position = 0;
+      decoder->skip = false;
+    }
+    else if (!decoder->skip)
+    {
+      if (decoder->position < sizeof(decoder->arena))
+      {
+        decoder->arena[decoder->position++] = value;
+      }
+      else
+      {
+        ++decoder->errors;
+        decoder->skip = true;
+      }
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static size_t getTimestampLength(enum TimestampFormat format)
+{
+  switch (format)
+  {
+    case TIMESTAMP_16_BIT:
+      return 4;
+
+    case TIMESTAMP_32_BIT:
+      return 8;
+
+    default:
+      return 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool hasBinaryDrops(const uint8_t *record)
+{
+  uint32_t word;
+
+  memcpy(&word, record + 2, sizeof(word));
+  return (fromLittleEndian32(word) & BIN_ID_DROPS) != 0;
+}
+/*----------------------------------------------------------------------------*/
+static bool hasBinarySequence(const uint8_t *record)
+{
+  uint32_t word;
+
+  memcpy(&word, record + 2, sizeof(word));
+  return (fromLittleEndian32(word) & BIN_ID_SEQUENCE) != 0;
+}
+/*----------------------------------------------------------------------------*/
+static bool isFrameType(uint8_t type)
+{
+  switch (type | ('a' - 'A'))
+  {
+    case 'b':
+    case 'd':
+    case 'r':
+    case 't':
+      return true;
+
+    default:
+      return false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void pushFrame(struct StreamDecoder *decoder,
+    const struct ProxyMessage *message, const uint16_t *sequence)
+{
+  ++decoder->frames;
+
+  if (decoder->callback != NULL)
+    decoder->callback(decoder->argument, message, sequence);
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t unpackByte(const uint8_t *text)
+{
+  return (uint8_t)((hexToBin(text[0]) << 4) | hexToBin(text[1]));
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t unpackTimestamp(const uint8_t *text,
+    enum TimestampFormat format)
+{
+  switch (format)
+  {
+    case TIMESTAMP_16_BIT:
+      return inPlaceHexToBin4(text);
+
+    case TIMESTAMP_32_BIT:
+      return ((uint32_t)inPlaceHexToBin4(text) << 16)
+          | inPlaceHexToBin4(text + 4);
+
+    default:
+      return 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void streamDecoderInit(struct StreamDecoder *decoder, enum StreamFormat format,
+    enum TimestampFormat timestamps, bool sequences,
+    StreamFrameCallback callback, void *argument)
+{
+  decoder->callback = callback;
+  decoder->argument = argument;
+  decoder->position = 0;
+  decoder->skip = false;
+  decoder->frames = 0;
+  decoder->errors = 0;
+  decoder->dropped[0] = 0;
+  decoder->dropped[1] = 0;
+  decoder->format = format;
+  decoder->timestamps = timestamps;
+  decoder->sequences = sequences;
+
+  resetDeltaDictionary(&decoder->dictionary);
+}
+/*----------------------------------------------------------------------------*/
+void streamDecoderPush(struct StreamDecoder *decoder, const void *input,
+    size_t count)
+{
+  if (decoder->format == STREAM_BINARY)
+    decodeBinary(decoder, input, count);
+  else
+    decodeText(decoder, input, count);
+}
@@ -0,0 +1,60 @@
+/*
+ * tests/stream_decoder.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef TESTS_STREAM_DECODER_H_
+#define TESTS_STREAM_DECODER_H_
+/*----------------------------------------------------------------------------*/
+#include "can_proxy_defs.h"
+#include <stdbool.h>
+/*----------------------------------------------------------------------------*/
+/* Sequence number is passed when the record carries it, NULL otherwise */
+typedef void (*StreamFrameCallback)(void *, const struct ProxyMessage *,
+    const uint16_t *);
+
+/* Formats of received frames selected with the E command */
+enum [[gnu::packed]] StreamFormat
+{
+  STREAM_TEXT,
+  STREAM_BINARY,
+  STREAM_DELTA
+};
+
+/* Host side decoder of the frame stream sent by the proxy */
+struct StreamDecoder
+{
+  StreamFrameCallback callback;
+  void *argument;
+
+  /* Frames of the delta stream */
+  struct DeltaDictionary dictionary;
+
+  /* Incomplete record from the previous input chunk */
+  uint8_t arena[SERIALIZED_FRAME_MTU + DELTA_KEY_OFFSET + SEQ_TEXT_LENGTH];
+  size_t position;
+  /* Current line is too long and is skipped up to the end of line */
+  bool skip;
+
+  /* Decoded frames and rejected records */
+  size_t frames;
+  size_t errors;
+  /* Must-deliver and low-priority frames reported by binary drop markers */
+  uint32_t dropped[2];
+
+  enum StreamFormat format;
+  enum TimestampFormat timestamps;
+  /* Text records end with sequence numbers, binary records flag them */
+  bool sequences;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void streamDecoderInit(struct StreamDecoder *, enum StreamFormat,
+    enum TimestampFormat, bool, StreamFrameCallback, void *);
+void streamDecoderPush(struct StreamDecoder *, const void *, size_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* TESTS_STREAM_DECODER_H_ */
@@ -0,0 +1,99 @@
+/*
+ * tests/test_batch_policy.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "batch_policy.h"
+#include "unit.h"
+/*----------------------------------------------------------------------------*/
+#define DEADLINE  1000
+#define RECORD    20
+/*----------------------------------------------------------------------------*/
+static void testBudget(void);
+static void testDeadline(void);
+static void testDisabled(void);
+static void testLeftovers(void);
+/*----------------------------------------------------------------------------*/
+static void testBudget(void)
+{
+  struct BatchPolicy policy;
+
+  batchPolicyDisable(&policy);
+  batchPolicyEnable(&policy, DEADLINE, RECORD, 0);
+
+  /* Batch is flushed when the budget of one packet is filled */
+  const size_t full = (SERIAL_MTU + RECORD - 1) / RECORD;
+
+  EXPECT(!batchPolicyCheck(&policy, full - 1, 10));
+  EXPECT(batchPolicyCheck(&policy, full, 20));
+
+  /* Sparse traffic reduces the budget to a single frame */
+  for (size_t i = 0; i < 32; ++i)
+    batchPolicyUpdate(&policy, RECORD, 1, 0, (uint32_t)(i + 1) * 100000);
+
+  EXPECT(policy.budget == RECORD);
+  EXPECT(batchPolicyCheck(&policy, 1, 3200001));
+}
+/*----------------------------------------------------------------------------*/
+static void testDeadline(void)
+{
+  struct BatchPolicy policy;
+
+  batchPolicyDisable(&policy);
+  batchPolicyEnable(&policy, DEADLINE, RECORD, 0);
+
+  /* Deadline is counted from the moment the first frame was noticed */
+  EXPECT(!batchPolicyCheck(&policy, 0, 100));
+  EXPECT(!policy.pending);
+  EXPECT(!batchPolicyCheck(&policy, 1, 500));
+  EXPECT(policy.pending && policy.started == 500);
+  EXPECT(batchPolicyRemaining(&policy, 500) == DEADLINE);
+  EXPECT(batchPolicyRemaining(&policy, 700) == DEADLINE - 200);
+  EXPECT(!batchPolicyCheck(&policy, 1, 500 + DEADLINE - 1));
+  EXPECT(batchPolicyCheck(&policy, 1, 500 + DEADLINE));
+  EXPECT(batchPolicyRemaining(&policy, 500 + DEADLINE + 1) == 0);
+
+  batchPolicyUpdate(&policy, RECORD, 1, 0, 500 + DEADLINE);
+  EXPECT(!policy.pending);
+  EXPECT(batchPolicyRemaining(&policy, 500 + DEADLINE) == 0);
+}
+/*----------------------------------------------------------------------------*/
+static void testDisabled(void)
+{
+  struct BatchPolicy policy;
+
+  batchPolicyDisable(&policy);
+
+  /* Frames are forwarded immediately without batching */
+  EXPECT(batchPolicyCheck(&policy, 0, 0));
+  EXPECT(batchPolicyCheck(&policy, 1, 0));
+  EXPECT(!policy.pending);
+}
+/*----------------------------------------------------------------------------*/
+static void testLeftovers(void)
+{
+  struct BatchPolicy policy;
+
+  batchPolicyDisable(&policy);
+  batchPolicyEnable(&policy, DEADLINE, RECORD, 0);
+
+  EXPECT(!batchPolicyCheck(&policy, 1, 100));
+  EXPECT(batchPolicyCheck(&policy, 1, 100 + DEADLINE));
+
+  /* Frames left after the flush wait for their own deadline */
+  batchPolicyUpdate(&policy, RECORD, 1, 1, 100 + DEADLINE);
+  EXPECT(policy.pending && policy.started == 100 + DEADLINE);
+  EXPECT(!batchPolicyCheck(&policy, 1, 101 + DEADLINE));
+  EXPECT(batchPolicyCheck(&policy, 1, 100 + DEADLINE * 2));
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  testBudget();
+  testDeadline();
+  testDisabled();
+  testLeftovers();
+
+  return unitResult();
+}
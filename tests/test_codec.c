@@ -0,0 +1,487 @@
+/*
+ * tests/test_codec.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "frame_mix.h"
+#include "stream_decoder.h"
+#include "unit.h"
+#include <halm/generic/can.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+struct Collector
+{
+  struct ProxyMessage *frames;
+  uint16_t *sequences;
+  size_t capacity;
+  size_t count;
+  /* Frames received with sequence numbers */
+  size_t numbered;
+};
+/*----------------------------------------------------------------------------*/
+static void collectFrame(void *, const struct ProxyMessage *,
+    const uint16_t *);
+static bool compareFrames(const struct ProxyMessage *,
+    const struct ProxyMessage *, uint32_t);
+static void decodeStream(struct StreamDecoder *, const uint8_t *, size_t,
+    uint32_t);
+static uint16_t makeSequence(size_t);
+static uint8_t *makeStream(const struct FrameMix *, enum StreamFormat,
+    enum TimestampFormat, bool, size_t *);
+static void testMix(const struct FrameMix *, enum StreamFormat,
+    enum TimestampFormat, bool);
+static void testDelta(const struct FrameMix *);
+static void testDropMarker(void);
+static void testPadding(void);
+static void testRejected(void);
+static void testResponses(void);
+static void testSequenceFields(void);
+/*----------------------------------------------------------------------------*/
+static void collectFrame(void *argument, const struct ProxyMessage *message,
+    const uint16_t *sequence)
+{
+  struct Collector * const collector = argument;
+
+  if (collector->count < collector->capacity)
+  {
+    collector->frames[collector->count] = *message;
+
+    if (sequence != NULL && collector->sequences != NULL)
+      collector->sequences[collector->count] = *sequence;
+  }
+
+  if (sequence != NULL)
+    ++collector->numbered;
+  ++collector->count;
+}
+/*----------------------------------------------------------------------------*/
+static bool compareFrames(const struct ProxyMessage *expected,
+    const struct ProxyMessage *received, uint32_t mask)
+{
+  if (expected->id != received->id || expected->flags != received->flags
+      || expected->length != received->length)
+  {
+    return false;
+  }
+  if ((expected->timestamp & mask) != received->timestamp)
+    return false;
+
+  /* Remote frames have no data field */
+  return (expected->flags & CAN_RTR)
+      || !memcmp(expected->data, received->data, expected->length);
+}
+/*----------------------------------------------------------------------------*/
+static void decodeStream(struct StreamDecoder *decoder, const uint8_t *stream,
+    size_t length, uint32_t seed)
+{
+  size_t offset = 0;
+
+  /* Chunks of random size split records at arbitrary positions */
+  while (offset < length)
+  {
+    const size_t random = 1 + frameMixRandom(&seed) % 97;
+    const size_t chunk = MIN(random, length - offset);
+
+    streamDecoderPush(decoder, stream + offset, chunk);
+    offset += chunk;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static uint16_t makeSequence(size_t index)
+{
+  /* Numbers wrap around within the stream */
+  return (uint16_t)(65000 + index);
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t *makeStream(const struct FrameMix *mix,
+    enum StreamFormat format, enum TimestampFormat timestamps, bool sequences,
+    size_t *length)
+{
+  uint8_t * const stream = malloc(mix->count * (SERIALIZED_FRAME_MTU
+      + DELTA_KEY_OFFSET + 2 * FRAME_DATA_MAX + SEQ_TEXT_LENGTH));
+  struct DeltaDictionary dictionary;
+  size_t position = 0;
+
+  if (stream == NULL)
+    abort();
+
+  resetDeltaDictionary(&dictionary);
+
+  for (size_t i = 0; i < mix->count; ++i)
+  {
+    const struct ProxyMessage * const message = mix->frames + i;
+    size_t record;
+
+    switch (format)
+    {
+      case STREAM_BINARY:
+        record = packBinaryFrame(stream + position, message,
+            timestamps != TIMESTAMP_NONE);
+        break;
+
+      case STREAM_DELTA:
+        record = packDeltaFrames(&dictionary, stream + position, message,
+            1, timestamps);
+        break;
+
+      default:
+        record = packFrame(stream + position, message, timestamps);
+        break;
+    }
+
+    if (sequences)
+    {
+      record = packSequence(stream + position, record, makeSequence(i),
+          format == STREAM_BINARY);
+    }
+
+    position += record;
+  }
+
+  *length = position;
+  return stream;
+}
+/*----------------------------------------------------------------------------*/
+static void testDelta(const struct FrameMix *cyclic)
+{
+  static const char text[] =
+      "x0100\rk01t1232AABB\rx0101CC\rx0104DD\rx01\rx0102\r";
+
+  struct ProxyMessage frames[4];
+  struct Collector collector = {
+      .frames = frames,
+      .sequences = NULL,
+      .capacity = ARRAY_SIZE(frames),
+      .count = 0,
+      .numbered = 0
+  };
+  struct StreamDecoder decoder;
+
+  /* Empty entries, bytes outside of the data field and short records */
+  streamDecoderInit(&decoder, STREAM_DELTA, TIMESTAMP_NONE, false,
+      collectFrame, &collector);
+  streamDecoderPush(&decoder, text, sizeof(text) - 1);
+
+  EXPECT(decoder.errors == 4);
+  if (EXPECT(collector.count == 2))
+  {
+    EXPECT(frames[0].id == 0x123 && frames[0].length == 2);
+    EXPECT(frames[0].data[0] == 0xAA && frames[0].data[1] == 0xBB);
+    EXPECT(frames[1].id == 0x123 && frames[1].length == 2);
+    EXPECT(frames[1].data[0] == 0xCC && frames[1].data[1] == 0xBB);
+  }
+
+  /* Periodic frames with few changed bytes are compressed */
+  size_t deltaLength;
+  size_t textLength;
+  uint8_t * const delta = makeStream(cyclic, STREAM_DELTA, TIMESTAMP_16_BIT,
+      false, &deltaLength);
+  uint8_t * const plain = makeStream(cyclic, STREAM_TEXT, TIMESTAMP_16_BIT,
+      false, &textLength);
+
+  EXPECT(deltaLength * 3 < textLength * 2);
+
+  free(plain);
+  free(delta);
+}
+/*----------------------------------------------------------------------------*/
+static void testDropMarker(void)
+{
+  const struct ProxyMessage message = {
+      .id = 0x123,
+      .length = 1,
+      .data = {0xAA}
+  };
+  struct ProxyMessage frames[2];
+  struct Collector collector = {
+      .frames = frames,
+      .sequences = NULL,
+      .capacity = ARRAY_SIZE(frames),
+      .count = 0,
+      .numbered = 0
+  };
+  struct StreamDecoder decoder;
+  struct ProxyMessage rejected;
+  uint8_t stream[BIN_MAX_LENGTH * 2 + BIN_DROPS_LENGTH + SEQ_BIN_LENGTH];
+  uint32_t counters[2];
+  size_t length;
+
+  /* Marker is a frame record with a flagged identifier and two counters */
+  length = packBinaryFrame(stream, &message, false);
+  EXPECT(packBinaryDrops(stream + length, 3, 0x01020304UL)
+      == BIN_DROPS_LENGTH);
+  EXPECT(stream[length + 5] == 0x40 && stream[length + 6] == 0x03);
+  EXPECT(getBinaryFrameLength(stream[length + 1]) == BIN_DROPS_LENGTH);
+  EXPECT(!unpackBinaryFrame(stream + length, BIN_DROPS_LENGTH, &rejected));
+  EXPECT(!unpackBinaryDrops(stream, length, counters));
+
+  if (EXPECT(unpackBinaryDrops(stream + length, BIN_DROPS_LENGTH, counters)))
+    EXPECT(counters[0] == 3 && counters[1] == 0x01020304UL);
+
+  /* Frames after the marker are numbered, the marker itself is not */
+  length += BIN_DROPS_LENGTH;
+
+  const size_t record = packBinaryFrame(stream + length, &message, false);
+
+  length += packSequence(stream + length, record, 7, true);
+
+  streamDecoderInit(&decoder, STREAM_BINARY, TIMESTAMP_NONE, false,
+      collectFrame, &collector);
+  streamDecoderPush(&decoder, stream, length);
+
+  EXPECT(decoder.errors == 0);
+  EXPECT(decoder.dropped[0] == 3 && decoder.dropped[1] == 0x01020304UL);
+  EXPECT(collector.count == 2 && collector.numbered == 1);
+}
+/*----------------------------------------------------------------------------*/
+static void testMix(const struct FrameMix *mix, enum StreamFormat format,
+    enum TimestampFormat timestamps, bool sequences)
+{
+  static const uint32_t masks[] = {0, 0xFFFF, 0xFFFFFFFFUL};
+
+  struct Collector collector = {
+      .frames = calloc(mix->count, sizeof(struct ProxyMessage)),
+      .sequences = calloc(mix->count, sizeof(uint16_t)),
+      .capacity = mix->count,
+      .count = 0,
+      .numbered = 0
+  };
+  struct StreamDecoder decoder;
+  size_t length;
+  uint8_t * const stream = makeStream(mix, format, timestamps, sequences,
+      &length);
+  /* Binary records carry either no timestamp or a full 32-bit timestamp */
+  const uint32_t mask =
+      format == STREAM_BINARY && timestamps != TIMESTAMP_NONE ?
+      0xFFFFFFFFUL : masks[timestamps];
+
+  if (collector.frames == NULL || collector.sequences == NULL)
+    abort();
+
+  /* Binary records flag the sequence field, text records can not */
+  streamDecoderInit(&decoder, format, timestamps,
+      sequences && format != STREAM_BINARY, collectFrame, &collector);
+  decodeStream(&decoder, stream, length, 1);
+
+  EXPECT(decoder.errors == 0);
+  EXPECT(collector.numbered == (sequences ? collector.count : 0));
+
+  if (EXPECT(collector.count == mix->count))
+  {
+    for (size_t i = 0; i < mix->count; ++i)
+    {
+      if (!EXPECT(compareFrames(mix->frames + i, collector.frames + i, mask))
+          || !EXPECT(!sequences || collector.sequences[i] == makeSequence(i)))
+      {
+        fprintf(stderr, "mix %s, format %d, timestamps %d, sequences %d, "
+            "frame %zu\n", mix->name, format, timestamps, sequences, i);
+        break;
+      }
+    }
+  }
+
+  free(collector.sequences);
+  free(collector.frames);
+  free(stream);
+}
+/*----------------------------------------------------------------------------*/
+static void testPadding(void)
+{
+#ifdef CONFIG_CAN_FD
+  struct ProxyMessage message = {
+      .id = 0x123,
+      .flags = CAN_FD,
+      .length = 13
+  };
+  struct ProxyMessage received;
+  uint8_t record[SERIALIZED_FRAME_MTU];
+
+  for (size_t i = 0; i < ARRAY_SIZE(message.data); ++i)
+    message.data[i] = 0xFF;
+
+  /* Length between length codes is rounded up to 16 bytes */
+  size_t length = packFrame(record, &message, TIMESTAMP_NONE);
+
+  EXPECT(length == STD_DATA_OFFSET + 16 * 2 + 1);
+  EXPECT(record[STD_DATA_OFFSET - 1] == 'A');
+  EXPECT(unpackFrame(record, length - 1, &received));
+  EXPECT(received.length == 16 && received.data[12] == 0xFF);
+  EXPECT(received.data[13] == 0 && received.data[15] == 0);
+
+  length = packBinaryFrame(record, &message, false);
+
+  EXPECT(length == BIN_DATA_OFFSET + 16);
+  EXPECT(unpackBinaryFrame(record, length, &received));
+  EXPECT(received.length == 16 && received.data[12] == 0xFF);
+  EXPECT(received.data[13] == 0 && received.data[15] == 0);
+#endif
+}
+/*----------------------------------------------------------------------------*/
+static void testRejected(void)
+{
+  struct ProxyMessage message;
+
+  /* Truncated text frames and invalid lengths of classic frames */
+  EXPECT(!unpackFrame("t12", 3, &message));
+  EXPECT(!unpackFrame("t1239", 5, &message));
+  EXPECT(!unpackFrame("t1232001", 8, &message));
+  EXPECT(!unpackFrame("T0000012", 8, &message));
+  EXPECT(unpackFrame("t1232AABB", 9, &message));
+  EXPECT(message.id == 0x123 && message.length == 2);
+  EXPECT(message.data[0] == 0xAA && message.data[1] == 0xBB);
+
+  /* Invalid binary headers and out of range identifiers */
+  EXPECT(getBinaryFrameLength(0x09) == 0);
+  EXPECT(getBinaryFrameLength(BIN_FLAG_RTR | 0x08) == BIN_DATA_OFFSET);
+  EXPECT(getBinaryFrameLength(BIN_FLAG_TS | 0x08) == BIN_DATA_OFFSET + 12);
+
+  const uint8_t longStd[] = {BIN_FRAME_MARKER, 0x00, 0x00, 0x08, 0x00, 0x00};
+  const uint8_t longExt[] = {
+      BIN_FRAME_MARKER, BIN_FLAG_EXT, 0x00, 0x00, 0x00, 0x20
+  };
+
+  EXPECT(!unpackBinaryFrame(longStd, sizeof(longStd), &message));
+  EXPECT(!unpackBinaryFrame(longExt, sizeof(longExt), &message));
+  EXPECT(!unpackBinaryFrame(longExt, sizeof(longExt) - 1, &message));
+
+  /* Flagged identifiers are not accepted from the host */
+  uint8_t numbered[BIN_DATA_OFFSET + SEQ_BIN_LENGTH] = {
+      BIN_FRAME_MARKER, BIN_FLAG_EXT | BIN_FLAG_RTR
+  };
+
+  EXPECT(packSequence(numbered, BIN_DATA_OFFSET, 0x1234, true)
+      == sizeof(numbered));
+  EXPECT(numbered[5] == 0x80 && numbered[6] == 0x34 && numbered[7] == 0x12);
+  EXPECT(!unpackBinaryFrame(numbered, BIN_DATA_OFFSET, &message));
+#ifndef CONFIG_CAN_FD
+  EXPECT(getBinaryFrameLength(BIN_FLAG_FD) == 0);
+  EXPECT(!unpackFrame("d1230", 5, &message));
+#endif
+}
+/*----------------------------------------------------------------------------*/
+static void testResponses(void)
+{
+  static const char text[] =
+      "\r\aV1013\rz\rt1231AA\rt12\rT123456780\r"
+      "t4561BB0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF01\r";
+  static const uint8_t binary[] = {
+      '\r', BIN_FRAME_MARKER, 0x09, '\a',
+      BIN_FRAME_MARKER, 0x01, 0x23, 0x01, 0x00, 0x00, 0xCC, '\r'
+  };
+
+  struct ProxyMessage frames[4];
+  struct Collector collector = {
+      .frames = frames,
+      .sequences = NULL,
+      .capacity = ARRAY_SIZE(frames),
+      .count = 0,
+      .numbered = 0
+  };
+  struct StreamDecoder decoder;
+
+  /* Responses are skipped, truncated and too long lines are rejected */
+  streamDecoderInit(&decoder, STREAM_TEXT, TIMESTAMP_NONE, false, collectFrame,
+      &collector);
+  streamDecoderPush(&decoder, text, sizeof(text) - 1);
+
+  EXPECT(decoder.errors == 2);
+  if (EXPECT(collector.count == 2))
+  {
+    EXPECT(frames[0].id == 0x123 && frames[0].data[0] == 0xAA);
+    EXPECT(frames[1].id == 0x12345678 && frames[1].length == 0);
+    EXPECT(frames[1].flags == CAN_EXT_ID);
+  }
+
+  /* Records with invalid headers are dropped, search restarts after them */
+  collector.count = 0;
+  streamDecoderInit(&decoder, STREAM_BINARY, TIMESTAMP_NONE, false,
+      collectFrame, &collector);
+  streamDecoderPush(&decoder, binary, sizeof(binary));
+
+  EXPECT(decoder.errors == 1);
+  if (EXPECT(collector.count == 1))
+  {
+    EXPECT(frames[0].id == 0x123 && frames[0].length == 1);
+    EXPECT(frames[0].data[0] == 0xCC);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void testSequenceFields(void)
+{
+  /* Timestamp is followed by the separator and the sequence number */
+  static const char text[] =
+      "t1231AA1234:00FF\rT123456780ABCD:FFFF\r"
+      "t1231AA123400FF\rt1231AA1234;00FF\rt1231AA:0001\r";
+
+  struct ProxyMessage frames[2];
+  uint16_t sequences[ARRAY_SIZE(frames)];
+  struct Collector collector = {
+      .frames = frames,
+      .sequences = sequences,
+      .capacity = ARRAY_SIZE(frames),
+      .count = 0,
+      .numbered = 0
+  };
+  struct StreamDecoder decoder;
+
+  streamDecoderInit(&decoder, STREAM_TEXT, TIMESTAMP_16_BIT, true,
+      collectFrame, &collector);
+  streamDecoderPush(&decoder, text, sizeof(text) - 1);
+
+  /* Records without the separator or without the timestamp are rejected */
+  EXPECT(decoder.errors == 3);
+  if (EXPECT(collector.count == 2 && collector.numbered == 2))
+  {
+    EXPECT(frames[0].id == 0x123 && frames[0].data[0] == 0xAA);
+    EXPECT(frames[0].timestamp == 0x1234 && sequences[0] == 0x00FF);
+    EXPECT(frames[1].id == 0x12345678 && frames[1].length == 0);
+    EXPECT(frames[1].timestamp == 0xABCD && sequences[1] == 0xFFFF);
+  }
+
+  /* Packed records place the separator after the timestamp */
+  const struct ProxyMessage message = {
+      .timestamp = 0x1234,
+      .id = 0x123,
+      .length = 1,
+      .data = {0xAA}
+  };
+  uint8_t record[SERIALIZED_FRAME_MTU + SEQ_TEXT_LENGTH];
+  const size_t length = packSequence(record,
+      packFrame(record, &message, TIMESTAMP_16_BIT), 0x00FF, false);
+
+  EXPECT(length == 17 && !memcmp(record, text, length));
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  struct FrameMix mixes[FRAME_MIX_COUNT];
+  const size_t count = frameMixMakeAll(mixes, FRAME_MIX_SIZE, NULL);
+
+  testDelta(&mixes[2]);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    for (int format = STREAM_TEXT; format <= STREAM_DELTA; ++format)
+    {
+      for (int timestamps = TIMESTAMP_NONE; timestamps <= TIMESTAMP_32_BIT;
+          ++timestamps)
+      {
+        testMix(&mixes[i], (enum StreamFormat)format,
+            (enum TimestampFormat)timestamps, false);
+        testMix(&mixes[i], (enum StreamFormat)format,
+            (enum TimestampFormat)timestamps, true);
+      }
+    }
+
+    frameMixFree(&mixes[i]);
+  }
+
+  testDropMarker();
+  testPadding();
+  testRejected();
+  testResponses();
+  testSequenceFields();
+
+  return unitResult();
+}
@@ -0,0 +1,315 @@
+/*
+ * tests/test_filter_bank.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "filter_bank.h"
+#include "frame_mix.h"
+#include "unit.h"
+/*----------------------------------------------------------------------------*/
+static bool acceptNothing(struct Interface *, const struct FilterBank *);
+static bool matchBank(const struct FilterBank *,
+    const struct FilterBankLayout *, uint32_t, bool);
+static void makeRandomRules(struct IdFilter *, uint32_t);
+static void testCoverage(const struct FilterBankLayout *, uint32_t);
+static void testEntries(void);
+static void testLeftovers(void);
+static void testRangeLayout(void);
+static bool verifyBank(const struct FilterBank *,
+    const struct FilterBankLayout *, const struct IdFilter *, uint32_t);
+/*----------------------------------------------------------------------------*/
+/* Controller with identifier lists and masks, like bxCAN filter banks */
+static const struct FilterBankLayout listLayout = {
+    .program = acceptNothing,
+    .slots = 14,
+    .entries = {4, 2, 2, 1}
+};
+
+/* Controller with mask entries only */
+static const struct FilterBankLayout maskLayout = {
+    .program = acceptNothing,
+    .slots = 4,
+    .entries = {0, 0, 1, 1}
+};
+
+/* Controller with identifier lists and ranges, like the LPC17xx filter */
+static const struct FilterBankLayout rangeLayout = {
+    .program = acceptNothing,
+    .slots = 128,
+    .entries = {4, 2, 2, 1},
+    .ranges = true
+};
+/*----------------------------------------------------------------------------*/
+static bool acceptNothing(struct Interface *, const struct FilterBank *)
+{
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+static bool matchBank(const struct FilterBank *bank,
+    const struct FilterBankLayout *layout, uint32_t id, bool extended)
+{
+  const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+
+  for (size_t i = 0; i < bank->count; ++i)
+  {
+    const struct FilterBankEntry * const entry = bank->entries + i;
+    const bool list = entry->kind == FILTER_STD_ID
+        || entry->kind == FILTER_EXT_ID;
+    const bool wide = entry->kind == FILTER_EXT_ID
+        || entry->kind == FILTER_EXT_MASK;
+
+    if (wide != extended)
+      continue;
+
+    if (list)
+    {
+      if (entry->id == id)
+        return true;
+    }
+    else if (layout->ranges)
+    {
+      if (id >= (entry->id & ~entry->mask & limit)
+          && id <= ((entry->id | entry->mask) & limit))
+      {
+        return true;
+      }
+    }
+    else if (((id ^ entry->id) & ~entry->mask & limit) == 0)
+      return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+static void makeRandomRules(struct IdFilter *filter, uint32_t seed)
+{
+  const size_t count = 1 + frameMixRandom(&seed) % ID_FILTER_CAPACITY;
+
+  idFilterClear(filter);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const uint32_t value = frameMixRandom(&seed);
+    const bool extended = (value & 1) != 0;
+    const uint32_t limit = extended ? ID_FILTER_EXT_MASK : ID_FILTER_STD_MASK;
+    const uint32_t low = frameMixRandom(&seed) & limit;
+
+    switch ((value >> 1) % 3)
+    {
+      case 0:
+        idFilterAddRange(filter, extended, low, low);
+        break;
+
+      case 1:
+        idFilterAddRange(filter, extended, low,
+            MIN(low + (frameMixRandom(&seed) & 0x3F), limit));
+        break;
+
+      default:
+        idFilterAddMask(filter, extended, low,
+            frameMixRandom(&seed) & 0x10F);
+        break;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void testCoverage(const struct FilterBankLayout *layout, uint32_t seed)
+{
+  struct IdFilter * const filter = malloc(sizeof(struct IdFilter));
+  struct FilterBank * const bank = malloc(sizeof(struct FilterBank));
+
+  if (!EXPECT(filter != NULL && bank != NULL))
+    goto end;
+
+  for (size_t round = 0; round < 200; ++round)
+  {
+    makeRandomRules(filter, seed + (uint32_t)round);
+
+    if (!EXPECT(filterBankCompile(bank, layout, filter)))
+      break;
+    if (!verifyBank(bank, layout, filter, seed + (uint32_t)round))
+      break;
+  }
+
+end:
+  free(bank);
+  free(filter);
+}
+/*----------------------------------------------------------------------------*/
+static void testEntries(void)
+{
+  struct IdFilter * const filter = malloc(sizeof(struct IdFilter));
+  struct FilterBank * const bank = malloc(sizeof(struct FilterBank));
+
+  if (!EXPECT(filter != NULL && bank != NULL))
+    goto end;
+
+  /* Exact identifiers become list entries sorted by identifier */
+  idFilterClear(filter);
+  idFilterAddRange(filter, false, 0x300, 0x300);
+  idFilterAddRange(filter, true, 0x18FF0001UL, 0x18FF0001UL);
+  idFilterAddRange(filter, false, 0x100, 0x100);
+
+  EXPECT(filterBankCompile(bank, &listLayout, filter));
+  EXPECT(bank->count == 3 && bank->leftovers == 0);
+  EXPECT(bank->entries[0].kind == FILTER_STD_ID
+      && bank->entries[0].id == 0x100);
+  EXPECT(bank->entries[1].kind == FILTER_STD_ID
+      && bank->entries[1].id == 0x300);
+  EXPECT(bank->entries[2].kind == FILTER_EXT_ID
+      && bank->entries[2].id == 0x18FF0001UL);
+  EXPECT(bank->slots[FILTER_STD_ID] == 1 && bank->slots[FILTER_EXT_ID] == 1);
+
+  /* Aligned range is one mask entry */
+  idFilterClear(filter);
+  idFilterAddRange(filter, false, 0x100, 0x17F);
+
+  EXPECT(filterBankCompile(bank, &maskLayout, filter));
+  EXPECT(bank->count == 1 && bank->leftovers == 0);
+  EXPECT(bank->entries[0].kind == FILTER_STD_MASK
+      && bank->entries[0].id == 0x100 && bank->entries[0].mask == 0x07F);
+
+  /* Unaligned range is split into aligned blocks */
+  idFilterClear(filter);
+  idFilterAddRange(filter, false, 0x101, 0x104);
+
+  EXPECT(filterBankCompile(bank, &maskLayout, filter));
+  EXPECT(bank->count == 3 && bank->leftovers == 0);
+  EXPECT(bank->entries[0].id == 0x101 && bank->entries[0].mask == 0);
+  EXPECT(bank->entries[1].id == 0x102 && bank->entries[1].mask == 1);
+  EXPECT(bank->entries[2].id == 0x104 && bank->entries[2].mask == 0);
+
+  /* Acceptance code and mask apply to both identifier types */
+  idFilterClear(filter);
+  idFilterSetCode(filter, 0x00000120UL);
+  idFilterSetMask(filter, 0x0000000FUL);
+
+  EXPECT(filterBankCompile(bank, &maskLayout, filter));
+  EXPECT(bank->count == 2 && bank->leftovers == 0);
+  EXPECT(bank->entries[0].kind == FILTER_STD_MASK
+      && bank->entries[0].id == 0x120 && bank->entries[0].mask == 0x00F);
+  EXPECT(bank->entries[1].kind == FILTER_EXT_MASK
+      && bank->entries[1].id == 0x120 && bank->entries[1].mask == 0x00F);
+
+end:
+  free(bank);
+  free(filter);
+}
+/*----------------------------------------------------------------------------*/
+static void testLeftovers(void)
+{
+  struct IdFilter * const filter = malloc(sizeof(struct IdFilter));
+  struct FilterBank * const bank = malloc(sizeof(struct FilterBank));
+
+  if (!EXPECT(filter != NULL && bank != NULL))
+    goto end;
+
+  /* Rules that do not fit are merged into one catch-all entry */
+  idFilterClear(filter);
+  for (uint32_t i = 0; i < 8; ++i)
+    idFilterAddRange(filter, false, 0x200 + i * 0x10, 0x200 + i * 0x10);
+
+  EXPECT(filterBankCompile(bank, &maskLayout, filter));
+  EXPECT(bank->count == maskLayout.slots);
+  EXPECT(bank->leftovers + maskLayout.slots - 1 == 8);
+  EXPECT(verifyBank(bank, &maskLayout, filter, 1));
+
+  /* First rules keep their own entries */
+  EXPECT(matchBank(bank, &maskLayout, 0x200, false));
+  EXPECT(matchBank(bank, &maskLayout, 0x270, false));
+
+end:
+  free(bank);
+  free(filter);
+}
+/*----------------------------------------------------------------------------*/
+static void testRangeLayout(void)
+{
+  struct IdFilter * const filter = malloc(sizeof(struct IdFilter));
+  struct FilterBank * const bank = malloc(sizeof(struct FilterBank));
+
+  if (!EXPECT(filter != NULL && bank != NULL))
+    goto end;
+
+  /* Contiguous mask is an exact range */
+  idFilterClear(filter);
+  idFilterAddMask(filter, true, 0x18FF0000UL, 0x000000FFUL);
+
+  EXPECT(filterBankCompile(bank, &rangeLayout, filter));
+  EXPECT(bank->count == 1 && bank->leftovers == 0);
+
+  /* Mask with gaps is widened and should be checked by software */
+  idFilterClear(filter);
+  idFilterAddMask(filter, false, 0x100, 0x0F0);
+
+  EXPECT(filterBankCompile(bank, &rangeLayout, filter));
+  EXPECT(bank->count == 1 && bank->leftovers == 1);
+  EXPECT(matchBank(bank, &rangeLayout, 0x101, false));
+  EXPECT(!idFilterMatch(filter, 0x101, false));
+  EXPECT(verifyBank(bank, &rangeLayout, filter, 1));
+
+end:
+  free(bank);
+  free(filter);
+}
+/*----------------------------------------------------------------------------*/
+static bool verifyBank(const struct FilterBank *bank,
+    const struct FilterBankLayout *layout, const struct IdFilter *filter,
+    uint32_t seed)
+{
+  /* Hardware passes all wanted frames and only them without leftovers */
+  for (uint32_t id = 0; id <= ID_FILTER_STD_MASK; ++id)
+  {
+    const bool wanted = idFilterMatch(filter, id, false);
+    const bool passed = matchBank(bank, layout, id, false);
+
+    if (!EXPECT(passed || !wanted)
+        || !EXPECT(bank->leftovers || passed == wanted))
+    {
+      fprintf(stderr, "Standard identifier %03X\n", (unsigned int)id);
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < filter->count * 4 + 4096; ++i)
+  {
+    uint32_t id;
+
+    if (i < filter->count * 4)
+    {
+      /* Rule bounds and their neighbours are checked first */
+      const struct IdFilterRule * const rule = filter->rules + i / 4;
+      const uint32_t bound = (i & 2) ? rule->second : rule->first;
+
+      id = (bound + (i & 1)) & ID_FILTER_EXT_MASK;
+    }
+    else
+      id = frameMixRandom(&seed) & ID_FILTER_EXT_MASK;
+
+    const bool wanted = idFilterMatch(filter, id, true);
+    const bool passed = matchBank(bank, layout, id, true);
+
+    if (!EXPECT(passed || !wanted)
+        || !EXPECT(bank->leftovers || passed == wanted))
+    {
+      fprintf(stderr, "Extended identifier %08X\n", (unsigned int)id);
+      return false;
+    }
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  testEntries();
+  testLeftovers();
+  testRangeLayout();
+
+  testCoverage(&listLayout, 1);
+  testCoverage(&maskLayout, 2);
+  testCoverage(&rangeLayout, 3);
+
+  return unitResult();
+}
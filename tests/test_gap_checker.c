@@ -0,0 +1,142 @@
+/*
+ * tests/test_gap_checker.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "frame_mix.h"
+#include "gap_checker.h"
+#include "stream_decoder.h"
+#include "unit.h"
+/*----------------------------------------------------------------------------*/
+struct StreamCheck
+{
+  struct GapChecker checker;
+  struct SequenceGap gaps[4];
+  size_t count;
+};
+/*----------------------------------------------------------------------------*/
+static void checkFrame(void *, const struct ProxyMessage *, const uint16_t *);
+static void testNumbers(void);
+static void testStream(enum StreamFormat);
+/*----------------------------------------------------------------------------*/
+static void checkFrame(void *argument, const struct ProxyMessage *message,
+    const uint16_t *sequence)
+{
+  struct StreamCheck * const check = argument;
+  struct SequenceGap gap;
+
+  if (!EXPECT(sequence != NULL))
+    return;
+
+  if (gapCheckerPush(&check->checker, *sequence, message->timestamp, &gap)
+      && check->count < ARRAY_SIZE(check->gaps))
+  {
+    check->gaps[check->count++] = gap;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void testNumbers(void)
+{
+  struct GapChecker checker;
+  struct SequenceGap gap;
+
+  gapCheckerInit(&checker);
+
+  /* First frame starts the sequence, numbers wrap around at 65536 */
+  EXPECT(!gapCheckerPush(&checker, 65534, 100, &gap));
+  EXPECT(!gapCheckerPush(&checker, 65535, 200, &gap));
+  EXPECT(!gapCheckerPush(&checker, 0, 300, &gap));
+
+  /* Frames lost across the wrap point */
+  EXPECT(gapCheckerPush(&checker, 65533, 400, &gap));
+  EXPECT(gap.first == 1 && gap.count == 65532);
+  EXPECT(gap.before == 300 && gap.after == 400);
+
+  EXPECT(gapCheckerPush(&checker, 2, 500, &gap));
+  EXPECT(gap.first == 65534 && gap.count == 4);
+  EXPECT(gap.before == 400 && gap.after == 500);
+
+  /* Repeated number is not a gap */
+  EXPECT(!gapCheckerPush(&checker, 2, 600, &gap));
+  EXPECT(!gapCheckerPush(&checker, 3, 700, NULL));
+
+  EXPECT(checker.frames == 7);
+  EXPECT(checker.gaps == 2);
+  EXPECT(checker.missing == 65536);
+  EXPECT(checker.repeated == 1);
+}
+/*----------------------------------------------------------------------------*/
+static void testStream(enum StreamFormat format)
+{
+  /* Records of these frames are lost on the way to the host */
+  static const size_t lost[] = {0, 5, 6, 7, 300};
+
+  struct FrameMix mix;
+  struct StreamCheck check = {.count = 0};
+  struct StreamDecoder decoder;
+  struct DeltaDictionary dictionary;
+  const bool binary = format == STREAM_BINARY;
+  size_t next = 0;
+
+  frameMixMakeRandom(&mix, 512, 1);
+  if (!EXPECT(mix.frames != NULL))
+    return;
+
+  gapCheckerInit(&check.checker);
+  resetDeltaDictionary(&dictionary);
+  streamDecoderInit(&decoder, format, TIMESTAMP_32_BIT, !binary, checkFrame,
+      &check);
+
+  for (size_t i = 0; i < mix.count; ++i)
+  {
+    uint8_t record[SERIALIZED_FRAME_MTU + DELTA_KEY_OFFSET + SEQ_TEXT_LENGTH];
+    size_t length;
+
+    if (next < ARRAY_SIZE(lost) && lost[next] == i)
+    {
+      ++next;
+      continue;
+    }
+
+    if (binary)
+    {
+      length = packBinaryFrame(record, mix.frames + i, true);
+    }
+    else if (format == STREAM_DELTA)
+    {
+      length = packDeltaFrames(&dictionary, record, mix.frames + i, 1,
+          TIMESTAMP_32_BIT);
+    }
+    else
+      length = packFrame(record, mix.frames + i, TIMESTAMP_32_BIT);
+
+    length = packSequence(record, length, (uint16_t)i, binary);
+    streamDecoderPush(&decoder, record, length);
+  }
+
+  /* Loss of the first frame is not visible */
+  EXPECT(decoder.errors == 0);
+  EXPECT(check.checker.frames == mix.count - ARRAY_SIZE(lost));
+  EXPECT(check.checker.gaps == 2 && check.checker.missing == 4);
+
+  if (EXPECT(check.count == 2))
+  {
+    EXPECT(check.gaps[0].first == 5 && check.gaps[0].count == 3);
+    EXPECT(check.gaps[0].before == mix.frames[4].timestamp);
+    EXPECT(check.gaps[0].after == mix.frames[8].timestamp);
+    EXPECT(check.gaps[1].first == 300 && check.gaps[1].count == 1);
+  }
+
+  frameMixFree(&mix);
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  testNumbers();
+
+  for (int format = STREAM_TEXT; format <= STREAM_DELTA; ++format)
+    testStream((enum StreamFormat)format);
+
+  return unitResult();
+}
@@ -0,0 +1,322 @@
+/*
+ * tests/test_heavy_hitters.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#include "bench.h"
+#include "frame_mix.h"
+#include "heavy_hitters.h"
+#include "unit.h"
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+#define TOP_COUNT     16
+#define TRACE_LENGTH  200000
+/*----------------------------------------------------------------------------*/
+struct ExactCount
+{
+  uint32_t id;
+  uint32_t count;
+};
+
+struct ExactCounts
+{
+  struct ExactCount *entries;
+  size_t count;
+};
+
+struct Trace
+{
+  const char *name;
+  void (*make)(uint32_t *, size_t, uint32_t);
+};
+/*----------------------------------------------------------------------------*/
+static int compareCounts(const void *, const void *);
+static int compareIds(const void *, const void *);
+static bool countExact(struct ExactCounts *, const uint32_t *, size_t);
+static uint32_t findExact(const struct ExactCounts *, uint32_t);
+static void makeBursts(uint32_t *, size_t, uint32_t);
+static void makeCyclic(uint32_t *, size_t, uint32_t);
+static void makeUniform(uint32_t *, size_t, uint32_t);
+static void makeZipf(uint32_t *, size_t, uint32_t);
+static uint32_t randomId(uint32_t *);
+static void testTrace(const struct Trace *, struct HeavyHitters *);
+/*----------------------------------------------------------------------------*/
+static const struct Trace traces[] = {
+    {"zipf", makeZipf},
+    {"cyclic", makeCyclic},
+    {"bursts", makeBursts},
+    {"uniform", makeUniform}
+};
+/*----------------------------------------------------------------------------*/
+static int compareCounts(const void *a, const void *b)
+{
+  const struct ExactCount * const left = a;
+  const struct ExactCount * const right = b;
+
+  /* Descending order of counts */
+  return (left->count < right->count) - (left->count > right->count);
+}
+/*----------------------------------------------------------------------------*/
+static int compareIds(const void *a, const void *b)
+{
+  const uint32_t left = *(const uint32_t *)a;
+  const uint32_t right = *(const uint32_t *)b;
+
+  return (left > right) - (left < right);
+}
+/*----------------------------------------------------------------------------*/
+static bool countExact(struct ExactCounts *counts, const uint32_t *ids,
+    size_t length)
+{
+  uint32_t * const sorted = malloc(length * sizeof(uint32_t));
+
+  counts->entries = malloc(length * sizeof(struct ExactCount));
+  counts->count = 0;
+
+  if (sorted == NULL || counts->entries == NULL)
+  {
+    free(sorted);
+    return false;
+  }
+
+  memcpy(sorted, ids, length * sizeof(uint32_t));
+  qsort(sorted, length, sizeof(uint32_t), compareIds);
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    if (!counts->count || counts->entries[counts->count - 1].id != sorted[i])
+    {
+      counts->entries[counts->count++] = (struct ExactCount){
+          .id = sorted[i],
+          .count = 0
+      };
+    }
+
+    ++counts->entries[counts->count - 1].count;
+  }
+
+  free(sorted);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t findExact(const struct ExactCounts *counts, uint32_t id)
+{
+  const struct ExactCount * const entry = bsearch(&id, counts->entries,
+      counts->count, sizeof(struct ExactCount), compareIds);
+
+  return entry != NULL ? entry->count : 0;
+}
+/*----------------------------------------------------------------------------*/
+static void makeBursts(uint32_t *ids, size_t length, uint32_t seed)
+{
+  /* Long bursts of a few identifiers interleaved with unique identifiers */
+  uint32_t heavy[8];
+
+  for (size_t i = 0; i < ARRAY_SIZE(heavy); ++i)
+    heavy[i] = randomId(&seed);
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    const size_t burst = i / 2000;
+
+    if (burst % 2)
+      ids[i] = randomId(&seed);
+    else
+      ids[i] = heavy[(burst / 2) % ARRAY_SIZE(heavy)];
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void makeCyclic(uint32_t *ids, size_t length, uint32_t seed)
+{
+  /* Periodic frames with the identifiers of the cyclic mix and noise */
+  struct FrameMix mix;
+
+  frameMixMakeCyclic(&mix, FRAME_MIX_SIZE, seed);
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    if (mix.frames != NULL && frameMixRandom(&seed) % 4)
+      ids[i] = mix.frames[i % mix.count].id;
+    else
+      ids[i] = randomId(&seed);
+  }
+
+  frameMixFree(&mix);
+}
+/*----------------------------------------------------------------------------*/
+static void makeUniform(uint32_t *ids, size_t length, uint32_t seed)
+{
+  /* No heavy hitters, only the error bounds are checked */
+  for (size_t i = 0; i < length; ++i)
+    ids[i] = randomId(&seed) % (TRACE_LENGTH / 2);
+}
+/*----------------------------------------------------------------------------*/
+static void makeZipf(uint32_t *ids, size_t length, uint32_t seed)
+{
+  /* Identifier of rank k is seen with the probability proportional to 1/k */
+  static const size_t ranks = 4096;
+
+  double * const weights = malloc(ranks * sizeof(double));
+  uint32_t * const table = malloc(ranks * sizeof(uint32_t));
+  double sum = 0.0;
+
+  if (weights == NULL || table == NULL)
+  {
+    memset(ids, 0, length * sizeof(uint32_t));
+    goto end;
+  }
+
+  for (size_t i = 0; i < ranks; ++i)
+  {
+    sum += 1.0 / (double)(i + 1);
+    weights[i] = sum;
+    table[i] = randomId(&seed);
+  }
+
+  for (size_t i = 0; i < length; ++i)
+  {
+    const double value = (double)frameMixRandom(&seed) / 4294967296.0 * sum;
+    size_t low = 0;
+    size_t high = ranks - 1;
+
+    while (low < high)
+    {
+      const size_t middle = (low + high) / 2;
+
+      if (weights[middle] > value)
+        high = middle;
+      else
+        low = middle + 1;
+    }
+
+    ids[i] = table[low];
+  }
+
+end:
+  free(table);
+  free(weights);
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t randomId(uint32_t *seed)
+{
+  return frameMixRandom(seed) & 0x1FFFFFFFUL;
+}
+/*----------------------------------------------------------------------------*/
+static void testTrace(const struct Trace *trace, struct HeavyHitters *sketch)
+{
+  struct HitterEstimate estimates[HEAVY_HITTERS_SIZE];
+  struct ExactCounts exact;
+  uint32_t * const ids = malloc(TRACE_LENGTH * sizeof(uint32_t));
+
+  if (!EXPECT(ids != NULL))
+    return;
+
+  trace->make(ids, TRACE_LENGTH, 1);
+  heavyHittersReset(sketch);
+
+  for (size_t i = 0; i < TRACE_LENGTH; ++i)
+    heavyHittersUpdate(sketch, ids[i]);
+
+  if (!EXPECT(countExact(&exact, ids, TRACE_LENGTH)))
+  {
+    free(ids);
+    return;
+  }
+
+  const size_t count = heavyHittersGetTop(sketch, estimates, 0,
+      ARRAY_SIZE(estimates));
+  const uint32_t threshold = TRACE_LENGTH / HEAVY_HITTERS_SIZE;
+  uint64_t sum = 0;
+  uint32_t overestimate = 0;
+
+  EXPECT(sketch->total == TRACE_LENGTH);
+  EXPECT(count == MIN(exact.count, HEAVY_HITTERS_SIZE));
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const struct HitterEstimate * const estimate = estimates + i;
+    const uint32_t real = findExact(&exact, estimate->id);
+
+    /* Real count lies between the guaranteed and the estimated counts */
+    EXPECT(estimate->count >= real);
+    EXPECT(estimate->count - estimate->error <= real);
+    EXPECT(!i || estimates[i - 1].count >= estimate->count);
+
+    overestimate = MAX(overestimate, estimate->count - real);
+    sum += estimate->count;
+  }
+
+  /* Counters of Space-Saving always sum up to the number of frames */
+  EXPECT(sum == TRACE_LENGTH);
+
+  qsort(exact.entries, exact.count, sizeof(struct ExactCount), compareCounts);
+
+  /* Top identifiers tied with the following ones are not ranked */
+  const uint32_t cutoff = exact.count > TOP_COUNT ?
+      exact.entries[TOP_COUNT].count : 0;
+  size_t ranked = 0;
+  size_t found = 0;
+  double relative = 0.0;
+
+  for (size_t i = 0; i < exact.count; ++i)
+  {
+    const struct ExactCount * const entry = exact.entries + i;
+    const struct HitterEstimate *estimate = NULL;
+
+    for (size_t j = 0; j < count; ++j)
+    {
+      if (estimates[j].id == entry->id)
+      {
+        estimate = estimates + j;
+        break;
+      }
+    }
+
+    /* Identifiers above the threshold are always tracked */
+    if (entry->count > threshold)
+      EXPECT(estimate != NULL);
+
+    if (i < TOP_COUNT && entry->count > cutoff)
+    {
+      ++ranked;
+
+      if (estimate != NULL)
+      {
+        relative += (double)(estimate->count - entry->count)
+            / (double)entry->count;
+        ++found;
+      }
+    }
+  }
+
+  benchReportValue("heavy_hitters", trace->name, "distinct",
+      (double)exact.count);
+  benchReportValue("heavy_hitters", trace->name, "top_ranked",
+      (double)ranked);
+  benchReportValue("heavy_hitters", trace->name, "top_recall",
+      ranked ? (double)found / (double)ranked : 1.0);
+  benchReportValue("heavy_hitters", trace->name, "top_relative_error",
+      found ? relative / (double)found : 0.0);
+  benchReportValue("heavy_hitters", trace->name, "max_overestimate",
+      (double)overestimate / (double)TRACE_LENGTH);
+  benchReportValue("heavy_hitters", trace->name, "error_bound",
+      (double)threshold / (double)TRACE_LENGTH);
+
+  free(exact.entries);
+  free(ids);
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  struct HeavyHitters * const sketch = malloc(sizeof(struct HeavyHitters));
+
+  if (!EXPECT(sketch != NULL))
+    return unitResult();
+
+  for (size_t i = 0; i < ARRAY_SIZE(traces); ++i)
+    testTrace(&traces[i], sketch);
+
+  free(sketch);
+  return unitResult();
+}
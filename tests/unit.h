@@ -0,0 +1,37 @@
+/*
+ * tests/unit.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+#ifndef TESTS_UNIT_H_
+#define TESTS_UNIT_H_
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+/* Failed checks are reported and counted, the test continues */
+#define EXPECT(condition) \
+    unitExpect((condition), #condition, __FILE__, __LINE__)
+
+static unsigned int unitFailures = 0;
+/*----------------------------------------------------------------------------*/
+static inline bool unitExpect(bool result, const char *condition,
+    const char *file, int line)
+{
+  if (!result)
+  {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+    ++unitFailures;
+  }
+
+  return result;
+}
+
+static inline int unitResult(void)
+{
+  return unitFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+/*----------------------------------------------------------------------------*/
+#endif /* TESTS_UNIT_H_ */